@@ -0,0 +1,96 @@
+#! /usr/bin/env python
+
+"""
+Measure the A* expansion throughput of K* for one or more builds on the
+instances bundled in misc/tests/benchmarks.
+
+Usage:
+  ./astar-throughput.py [--repeats N] [--search CONFIG] BUILD [BUILD ...]
+
+BUILD is passed to fast-downward.py --build, so e.g. compile the baseline
+into builds/base and the revision to test into builds/release64 and run
+  ./astar-throughput.py base release64
+
+For each build and task we report the number of expanded states, the time
+spent in A* steps ("A* search time") and the resulting expansions per
+second. The time is the minimum over all repetitions.
+"""
+
+from __future__ import print_function
+
+import argparse
+import os
+import re
+import subprocess
+import sys
+import tempfile
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_BASE = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO_BASE, "misc", "tests", "benchmarks")
+DRIVER = os.path.join(REPO_BASE, "fast-downward.py")
+
+TASKS = [
+    "gripper/prob01.pddl",
+    "miconic/s1-0.pddl",
+    "miconic-simpleadl/s1-0.pddl",
+    "philosophers/p01-phil2.pddl",
+]
+
+DEFAULT_SEARCH = "kstar(blind(),k=1000)"
+
+EXPANDED_RE = re.compile(r"^Expanded (\d+) state\(s\)\.$", re.M)
+ASTAR_TIME_RE = re.compile(r"^A\* search time: (.+)s$", re.M)
+SEARCH_TIME_RE = re.compile(r"^Search time: (.+)s$", re.M)
+
+
+def parse_args():
+    parser = argparse.ArgumentParser(description=__doc__,
+        formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("builds", nargs="+", metavar="BUILD")
+    parser.add_argument("--repeats", type=int, default=5)
+    parser.add_argument("--search", default=DEFAULT_SEARCH)
+    return parser.parse_args()
+
+
+def translate(build, task, cwd):
+    problem = os.path.join(BENCHMARKS_DIR, task)
+    subprocess.check_call(
+        [sys.executable, DRIVER, "--build", build, "--translate", problem],
+        cwd=cwd, stdout=open(os.devnull, "w"))
+    return os.path.join(cwd, "output.sas")
+
+
+def run_search(build, sas_file, search, cwd):
+    output = subprocess.check_output(
+        [sys.executable, DRIVER, "--build", build, sas_file,
+         "--search", search], cwd=cwd).decode()
+    expanded = int(EXPANDED_RE.search(output).group(1))
+    # Older builds do not report the A* time separately.
+    match = ASTAR_TIME_RE.search(output) or SEARCH_TIME_RE.search(output)
+    return expanded, float(match.group(1))
+
+
+def main():
+    args = parse_args()
+    tmp_dir = tempfile.mkdtemp(prefix="astar-throughput-")
+    print("{:30} {:12} {:>10} {:>10} {:>14}".format(
+        "task", "build", "expanded", "time", "expansions/s"))
+    for task in TASKS:
+        task_dir = os.path.join(tmp_dir, task.replace("/", "-"))
+        os.mkdir(task_dir)
+        sas_file = translate(args.builds[0], task, task_dir)
+        for build in args.builds:
+            times = []
+            for _ in range(args.repeats):
+                expanded, time = run_search(
+                    build, sas_file, args.search, task_dir)
+                times.append(time)
+            time = min(times)
+            throughput = expanded / time if time > 0 else float("inf")
+            print("{:30} {:12} {:>10} {:>10.4f} {:>14.0f}".format(
+                task, build, expanded, time, throughput))
+
+
+if __name__ == "__main__":
+    main()
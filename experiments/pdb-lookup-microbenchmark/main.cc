@@ -0,0 +1,118 @@
+#include <cstdlib>
+#include <ctime>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "globals.h"
+#include "option_parser.h"
+#include "sampling.h"
+#include "successor_generator.h"
+#include "task_proxy.h"
+#include "task_tools.h"
+
+#include "pdbs/canonical_pdbs.h"
+#include "pdbs/parallel_pdb_construction.h"
+#include "pdbs/pattern_collection_generator_systematic.h"
+#include "pdbs/pattern_collection_information.h"
+#include "pdbs/zero_one_pdbs.h"
+
+#include "utils/rng.h"
+
+using namespace std;
+using namespace pdbs;
+
+/*
+  Compares the scalar PDB lookup (get_value per state) with the batch
+  lookup (get_values) of canonical and zero-one PDBs. The patterns are
+  the systematic patterns up to the given size, the states are sampled
+  with random walks from the initial state.
+
+  Usage: ./benchmark [pattern_max_size [num_samples [num_runs]]] < output.sas
+*/
+
+
+void benchmark(const string &desc, int num_calls,
+               const function<void()> &func) {
+    cout << "Running " << desc << " " << num_calls << " times:" << flush;
+    clock_t start = clock();
+    for (int i = 0; i < num_calls; ++i)
+        func();
+    clock_t end = clock();
+    double duration = static_cast<double>(end - start) / CLOCKS_PER_SEC;
+    cout << " " << duration << " seconds" << endl;
+}
+
+void check_same_values(const string &desc, const vector<int> &scalar_values,
+                       const vector<int> &batch_values) {
+    if (scalar_values != batch_values) {
+        cerr << desc << ": batch lookup differs from scalar lookup" << endl;
+        exit(1);
+    }
+}
+
+
+int main(int argc, char **argv) {
+    const int PATTERN_MAX_SIZE = argc > 1 ? atoi(argv[1]) : 2;
+    const int NUM_SAMPLES = argc > 2 ? atoi(argv[2]) : 100000;
+    const int NUM_RUNS = argc > 3 ? atoi(argv[3]) : 10;
+    const int SEED = 2018;
+
+    read_everything(cin);
+    shared_ptr<AbstractTask> task = g_root_task();
+    TaskProxy task_proxy(*task);
+
+    Options opts;
+    opts.set<int>("pattern_max_size", PATTERN_MAX_SIZE);
+    opts.set<bool>("only_interesting_patterns", true);
+    PatternCollectionGeneratorSystematic generator(opts);
+    PatternCollectionInformation pattern_collection_info =
+        generator.generate(task);
+    shared_ptr<PatternCollection> patterns =
+        pattern_collection_info.get_patterns();
+    CanonicalPDBs canonical_pdbs(
+        pattern_collection_info.get_pdbs(),
+        pattern_collection_info.get_max_additive_subsets(), true);
+    ZeroOnePDBs zero_one_pdbs(
+        task_proxy, *patterns, ParallelPDBConstruction());
+
+    SuccessorGenerator successor_generator(task_proxy);
+    utils::RandomNumberGenerator rng(SEED);
+    int init_h = canonical_pdbs.get_value(task_proxy.get_initial_state());
+    vector<State> samples = sample_states_with_random_walks(
+        task_proxy, successor_generator, NUM_SAMPLES,
+        init_h == numeric_limits<int>::max() ? 0 : init_h,
+        get_average_operator_cost(task_proxy), rng);
+    cout << patterns->size() << " patterns, " << samples.size()
+         << " states" << endl << endl;
+
+    vector<int> scalar_values(samples.size());
+    vector<int> batch_values;
+
+    benchmark("canonical PDBs (scalar)",
+              NUM_RUNS,
+              [&]() {
+                  for (size_t i = 0; i < samples.size(); ++i)
+                      scalar_values[i] = canonical_pdbs.get_value(samples[i]);
+              });
+    benchmark("canonical PDBs (batch)",
+              NUM_RUNS,
+              [&]() {batch_values = canonical_pdbs.get_values(samples); });
+    check_same_values("canonical PDBs", scalar_values, batch_values);
+    cout << endl;
+
+    benchmark("zero-one PDBs (scalar)",
+              NUM_RUNS,
+              [&]() {
+                  for (size_t i = 0; i < samples.size(); ++i)
+                      scalar_values[i] = zero_one_pdbs.get_value(samples[i]);
+              });
+    benchmark("zero-one PDBs (batch)",
+              NUM_RUNS,
+              [&]() {batch_values = zero_one_pdbs.get_values(samples); });
+    check_same_values("zero-one PDBs", scalar_values, batch_values);
+    return 0;
+}
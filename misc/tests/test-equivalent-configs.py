@@ -0,0 +1,213 @@
+#! /usr/bin/env python
+
+"""
+Run groups of configurations that must give the same results, e.g.,
+because they only differ in an optimization, and compare the relevant
+parts of their output with each other and, where known, with the
+expected result.
+"""
+
+from __future__ import print_function
+
+import json
+import os
+import re
+import subprocess
+import sys
+
+DIR = os.path.dirname(os.path.abspath(__file__))
+REPO_BASE = os.path.dirname(os.path.dirname(DIR))
+BENCHMARKS_DIR = os.path.join(REPO_BASE, "misc", "tests", "benchmarks")
+DRIVER = os.path.join(REPO_BASE, "fast-downward.py")
+
+TASKS = [
+    "gripper/prob01.pddl",
+    "miconic/s1-0.pddl",
+]
+
+OPTIMAL_COSTS = {
+    "gripper/prob01.pddl": ["11"],
+    "miconic/s1-0.pddl": ["4"],
+}
+
+FIRST_PLAN_COST = r"First plan of cost (\d+)"
+
+# The description of the heuristic is left out, since it contains the
+# options that differ.
+SEARCH_RESULTS = (
+    r"Initial heuristic value for .*: (\d+)|Expanded (\d+) state\(s\)\.")
+
+# The merges and the steps after each merge of the construction log
+MERGE_AND_SHRINK_RESULTS = (
+    SEARCH_RESULTS + r"|(Next pair of indices: .*)|\((after [a-z ]+)\)")
+
+MERGE_AND_SHRINK = ("astar(merge_and_shrink("
+    "merge_strategy={merge_strategy},"
+    "shrink_strategy=shrink_bisimulation(greedy=false),"
+    "label_reduction=exact(before_shrinking=true,before_merging=false),"
+    "max_states=50000,threshold_before_merge=1,verbosity=normal,"
+    "construction_threads={{threads}}))")
+
+DFP = MERGE_AND_SHRINK.format(merge_strategy=(
+    "merge_stateless(merge_selector=score_based_filtering("
+    "scoring_functions=[goal_relevance,dfp,total_order]))"))
+
+LINEAR = MERGE_AND_SHRINK.format(
+    merge_strategy="merge_precomputed(merge_tree=linear())")
+
+# Without label reduction, the threads perform the independent merges of a
+# level of the balanced merge tree together.
+BALANCED = ("astar(merge_and_shrink("
+    "merge_strategy=merge_precomputed(merge_tree=balanced()),"
+    "shrink_strategy=shrink_bisimulation(greedy=false),"
+    "max_states=50000,threshold_before_merge=1,verbosity=normal,"
+    "construction_threads={threads}))")
+
+KSTAR = "kstar({heuristic}, k=10, save_plan_files=false, lazy_evaluation={lazy})"
+
+PLANS_FILE = "equivalent-configs-plans.jsonl"
+
+# Instead of matching the output, compare the sorted plans that the
+# configurations dump to PLANS_FILE. Duplicate plans are failures.
+PLANS = "plans"
+
+# Like PLANS, but only the plans within QUALITY_BOUND of the cheapest plan
+# are compared. A q-bounded search also dumps the plan after which it
+# stops, and this plan depends on how ties are broken.
+BOUNDED_PLANS = "bounded plans"
+QUALITY_BOUND = 1.2
+
+KSTAR_PLANS = ("kstar({search}, save_plan_files=false, "
+    "jsonl_file_to_dump=%s)" % PLANS_FILE)
+
+KSTAR_BOUNDED_PLANS = KSTAR_PLANS.format(
+    search="lmcut(), q=%s, {options}" % QUALITY_BOUND)
+
+
+def with_threads(config):
+    return [config.format(threads=threads) for threads in [1, 2]]
+
+
+# (description, configurations, regular expression for the compared
+# output, expected output per task or None)
+TESTS = [
+    ("first plan of kstar with lazy evaluation is optimal",
+     [KSTAR.format(heuristic="lmcut()", lazy="false"),
+      KSTAR.format(heuristic="lmcut()", lazy="true"),
+      KSTAR.format(heuristic="ipdb()", lazy="true"),
+      KSTAR.format(heuristic="blind()", lazy="true")],
+     FIRST_PLAN_COST, OPTIMAL_COSTS),
+    ("cpdbs gives the same results with 1 and 2 threads",
+     with_threads("astar(cpdbs(systematic(2), construction_threads={threads}))"),
+     SEARCH_RESULTS, None),
+    ("zopdbs gives the same results with 1 and 2 threads",
+     with_threads("astar(zopdbs(systematic(2), construction_threads={threads}))"),
+     SEARCH_RESULTS, None),
+    ("ipdb gives the same results with 1 and 2 threads",
+     with_threads("astar(ipdb(construction_threads={threads}))"),
+     SEARCH_RESULTS, None),
+    ("merge-and-shrink with DFP gives the same results with 1 and 2 threads",
+     with_threads(DFP), MERGE_AND_SHRINK_RESULTS, None),
+    ("merge-and-shrink with a linear merge tree gives the same results "
+     "with 1 and 2 threads",
+     with_threads(LINEAR), MERGE_AND_SHRINK_RESULTS, None),
+    ("merge-and-shrink with a balanced merge tree gives the same results "
+     "with 1 and 2 threads",
+     with_threads(BALANCED), MERGE_AND_SHRINK_RESULTS, None),
+    ("kstar finds no duplicate plans when states are reopened",
+     [KSTAR_PLANS.format(search="add(), k=2000")], PLANS, None),
+    ("kstar finds the same plans with 1 and 3 extraction threads",
+     [KSTAR_BOUNDED_PLANS.format(options="extraction_threads=1"),
+      KSTAR_BOUNDED_PLANS.format(options="extraction_threads=3")],
+     BOUNDED_PLANS, None),
+    ("kstar finds the same plans with 1 and 4 evaluation threads",
+     [KSTAR_BOUNDED_PLANS.format(options="evaluation_threads=1"),
+      KSTAR_BOUNDED_PLANS.format(options="evaluation_threads=4")],
+     BOUNDED_PLANS, None),
+    ("kstar finds the same plans with both path graph queues",
+     [KSTAR_BOUNDED_PLANS.format(options="pg_queue=heap"),
+      KSTAR_BOUNDED_PLANS.format(options="pg_queue=bucket")],
+     BOUNDED_PLANS, None),
+]
+
+
+def run_search(relpath, search):
+    problem = os.path.join(BENCHMARKS_DIR, relpath)
+    print("\nRun %(search)s on %(relpath)s:" % locals())
+    sys.stdout.flush()
+    output = subprocess.check_output(
+        [sys.executable, DRIVER, problem, "--search", search])
+    return output.decode("utf-8")
+
+
+def compares_plans(pattern):
+    return pattern in [PLANS, BOUNDED_PLANS]
+
+
+def read_plans(pattern):
+    with open(PLANS_FILE) as plans_file:
+        plans = [line.strip() for line in plans_file]
+    os.remove(PLANS_FILE)
+    if pattern == BOUNDED_PLANS and plans:
+        costs = [json.loads(plan)["cost"] for plan in plans]
+        bound = min(costs) * QUALITY_BOUND
+        plans = [plan for plan, cost in zip(plans, costs) if cost <= bound]
+    return sorted(plans)
+
+
+def has_duplicates(plans):
+    return len(set(plans)) != len(plans)
+
+
+def summarize(pattern, result):
+    if compares_plans(pattern):
+        return "%d plans, %d distinct" % (len(result), len(set(result)))
+    return result
+
+
+def cleanup():
+    subprocess.check_call([sys.executable, DRIVER, "--cleanup"])
+
+
+def main():
+    # On Windows, ./build.py has to be called from the correct environment.
+    # Since we want this script to work even when we are in a regular
+    # shell, we do not build on Windows. If the planner is not yet built,
+    # the driver script will complain about this.
+    if os.name == "posix":
+        subprocess.check_call(["./build.py"], cwd=REPO_BASE)
+    failures = []
+    for relpath in TASKS:
+        for description, searches, pattern, expected in TESTS:
+            results = []
+            for search in searches:
+                output = run_search(relpath, search)
+                if compares_plans(pattern):
+                    results.append(read_plans(pattern))
+                else:
+                    results.append(re.findall(pattern, output))
+                cleanup()
+            expected_result = expected[relpath] if expected else results[0]
+            if (not expected_result or
+                    any(result != expected_result for result in results) or
+                    (compares_plans(pattern) and
+                     any(has_duplicates(result) for result in results))):
+                failures.append((description, relpath, searches, pattern,
+                                 results, expected_result))
+
+    if failures:
+        print("\nFailures:")
+        for (description, relpath, searches, pattern, results,
+                expected_result) in failures:
+            expected_result = summarize(pattern, expected_result)
+            print("%(description)s on %(relpath)s, expected "
+                  "%(expected_result)s:" % locals())
+            for search, result in zip(searches, results):
+                result = summarize(pattern, result)
+                print("  %(search)s: %(result)s" % locals())
+        sys.exit(1)
+    else:
+        print("\nNo errors detected.")
+
+
+main()
@@ -41,6 +41,10 @@ TESTS = [
     ("strips", "astar(hm())", EXIT_PLAN_FOUND),
     ("strips", "ehc(hm())", EXIT_PLAN_FOUND),
     ("strips", "astar(ipdb())", EXIT_PLAN_FOUND),
+    ("strips", "astar(ipdb(construction_threads=2, construction_memory=64))",
+     EXIT_PLAN_FOUND),
+    ("strips", "astar(ipdb(max_time=10, storage=UINT8, dominance_pruning=true))",
+     EXIT_PLAN_FOUND),
     ("strips", "astar(lmcut())", EXIT_PLAN_FOUND),
     ("strips", "astar(lmcount(lm_rhw(), admissible=false))", EXIT_PLAN_FOUND),
     ("strips", "astar(lmcount(lm_rhw(), admissible=true))", EXIT_PLAN_FOUND),
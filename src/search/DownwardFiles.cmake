@@ -47,9 +47,11 @@ fast_downward_plugin(
     HELP "Core source files"
     SOURCES
         planner
+        planner_server
 
         abstract_task
         axioms
+        binary_task
         causal_graph
         evaluation_context
         evaluation_result
@@ -61,6 +63,7 @@ fast_downward_plugin(
         operator_cost
         option_parser
         option_parser_util
+        parallel_heuristic_evaluator
         per_state_information
         plugin
         pruning_method
@@ -130,6 +133,7 @@ fast_downward_plugin(
         utils/system
         utils/system_unix
         utils/system_windows
+        utils/thread_pool
         utils/timer
     CORE_PLUGIN
 )
@@ -478,6 +482,7 @@ fast_downward_plugin(
         merge_and_shrink/merge_strategy_stateless
         merge_and_shrink/merge_tree
         merge_and_shrink/merge_tree_factory
+        merge_and_shrink/merge_tree_factory_balanced
         merge_and_shrink/merge_tree_factory_linear
         merge_and_shrink/shrink_bisimulation
         merge_and_shrink/shrink_bucket_based
@@ -528,11 +533,13 @@ fast_downward_plugin(
     SOURCES
         pdbs/canonical_pdbs
         pdbs/canonical_pdbs_heuristic
+        pdbs/distance_table
         pdbs/dominance_pruning
         pdbs/incremental_canonical_pdbs
         pdbs/match_tree
         pdbs/max_additive_pdb_sets
         pdbs/max_cliques
+        pdbs/parallel_pdb_construction
         pdbs/pattern_collection_information
         pdbs/pattern_database
         pdbs/pattern_collection_generator_combo
@@ -543,7 +550,9 @@ fast_downward_plugin(
         pdbs/pattern_generator_greedy
         pdbs/pattern_generator_manual
         pdbs/pattern_generator
+        pdbs/pdb_cache
         pdbs/pdb_heuristic
+        pdbs/state_block
         pdbs/types
         pdbs/validation
         pdbs/zero_one_pdbs
@@ -579,7 +588,12 @@ fast_downward_plugin(
 	HELP "KStar algorithm"
     SOURCES
         kstar/kstar
+		kstar/pddl_strings
+		kstar/plan_extraction_pipeline
+		kstar/plan_fingerprints
 		kstar/plan_reconstructor
+		kstar/plan_sink
+		kstar/sequence_set
 		kstar/successor_generator
 		kstar/util
     DEPENDS NULL_PRUNING_METHOD ORDERED_SET SEARCH_COMMON TOP_K_EAGER_SEARCH
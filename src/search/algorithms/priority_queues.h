@@ -195,9 +195,7 @@ public:
     }
 
 	virtual Entry top() {
-
         assert(num_entries > 0);
-        --num_entries;
         update_current_bucket_no();
         Bucket &current_bucket = buckets[current_bucket_no];
         Value top_element = current_bucket.back();
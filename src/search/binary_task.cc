@@ -0,0 +1,397 @@
+#include "binary_task.h"
+
+#include "abstract_task.h"
+#include "global_operator.h"
+#include "globals.h"
+
+#include "utils/system.h"
+#include "utils/timer.h"
+
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace binary_task {
+static const char MAGIC[4] = {'K', 'S', 'T', 'K'};
+static const int FORMAT_VERSION = 1;
+
+class TaskWriter {
+    ostream &out;
+public:
+    explicit TaskWriter(ostream &out) : out(out) {
+    }
+
+    void write_magic() {
+        out.write(MAGIC, sizeof(MAGIC));
+    }
+
+    void write_int(int value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(int));
+    }
+
+    void write_string(const string &s) {
+        write_int(s.size());
+        out.write(s.data(), s.size());
+    }
+};
+
+class TaskReader {
+    const char *pos;
+    const char *end;
+
+    void check_available(size_t num_bytes) const {
+        if (static_cast<size_t>(end - pos) < num_bytes) {
+            cerr << "Unexpected end of binary task file." << endl;
+            utils::exit_with(ExitCode::INPUT_ERROR);
+        }
+    }
+public:
+    TaskReader(const char *data, size_t size)
+        : pos(data), end(data + size) {
+    }
+
+    bool read_magic() {
+        check_available(sizeof(MAGIC));
+        bool matches = memcmp(pos, MAGIC, sizeof(MAGIC)) == 0;
+        pos += sizeof(MAGIC);
+        return matches;
+    }
+
+    int read_int() {
+        check_available(sizeof(int));
+        int value;
+        memcpy(&value, pos, sizeof(int));
+        pos += sizeof(int);
+        return value;
+    }
+
+    string read_string() {
+        int length = read_int();
+        check_available(length);
+        string result(pos, length);
+        pos += length;
+        return result;
+    }
+
+    vector<GlobalCondition> read_conditions() {
+        int count = read_int();
+        vector<GlobalCondition> conditions;
+        conditions.reserve(count);
+        for (int i = 0; i < count; ++i) {
+            int var = read_int();
+            int value = read_int();
+            conditions.emplace_back(var, value);
+        }
+        return conditions;
+    }
+
+    // Adds the effect and its precondition (if any) like
+    // GlobalOperator::read_pre_post.
+    void read_pre_post(vector<GlobalCondition> &preconditions,
+                       vector<GlobalEffect> &effects) {
+        vector<GlobalCondition> conditions = read_conditions();
+        int var = read_int();
+        int pre = read_int();
+        int post = read_int();
+        if (pre != -1)
+            preconditions.emplace_back(var, pre);
+        effects.emplace_back(var, post, conditions);
+    }
+
+    bool at_end() const {
+        return pos == end;
+    }
+};
+
+static void check_magic_and_version(TaskReader &reader) {
+    if (!reader.read_magic()) {
+        cerr << "Not a binary task file." << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    int version = reader.read_int();
+    int pre_file_version = reader.read_int();
+    if (version != FORMAT_VERSION || pre_file_version != PRE_FILE_VERSION) {
+        cerr << "Binary task file has version " << version << " (preprocessor "
+             << "file version " << pre_file_version << "), expected "
+             << FORMAT_VERSION << " (" << PRE_FILE_VERSION << ")." << endl
+             << "Please convert the task again." << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+}
+
+static void read_task(TaskReader &reader) {
+    check_magic_and_version(reader);
+    g_use_metric = reader.read_int();
+
+    int num_variables = reader.read_int();
+    for (int var = 0; var < num_variables; ++var) {
+        g_variable_name.push_back(reader.read_string());
+        g_axiom_layers.push_back(reader.read_int());
+        int range = reader.read_int();
+        g_variable_domain.push_back(range);
+        vector<string> fact_names;
+        fact_names.reserve(range);
+        for (int value = 0; value < range; ++value)
+            fact_names.push_back(reader.read_string());
+        g_fact_names.push_back(move(fact_names));
+    }
+    add_goal_variable();
+
+    int num_mutex_groups = reader.read_int();
+    vector<vector<FactPair>> invariant_groups(num_mutex_groups);
+    for (vector<FactPair> &invariant_group : invariant_groups) {
+        int num_facts = reader.read_int();
+        invariant_group.reserve(num_facts);
+        for (int i = 0; i < num_facts; ++i) {
+            int var = reader.read_int();
+            int value = reader.read_int();
+            invariant_group.emplace_back(var, value);
+        }
+    }
+    add_mutex_groups(invariant_groups);
+
+    // The goal variable is not part of the file.
+    g_initial_state_data.resize(g_variable_domain.size());
+    for (int var = 0; var < num_variables; ++var)
+        g_initial_state_data[var] = reader.read_int();
+    g_initial_state_data[num_variables] = 0;
+    g_default_axiom_values = g_initial_state_data;
+
+    int num_goals = reader.read_int();
+    if (num_goals < 1) {
+        cerr << "Task has no goal condition!" << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    for (int i = 0; i < num_goals; ++i) {
+        int var = reader.read_int();
+        int value = reader.read_int();
+        g_goal.push_back(make_pair(var, value));
+    }
+
+    int num_operators = reader.read_int();
+    g_operators.reserve(num_operators + 1);
+    for (int i = 0; i < num_operators; ++i) {
+        string name = reader.read_string();
+        vector<GlobalCondition> preconditions = reader.read_conditions();
+        vector<GlobalEffect> effects;
+        int num_effects = reader.read_int();
+        effects.reserve(num_effects);
+        for (int j = 0; j < num_effects; ++j)
+            reader.read_pre_post(preconditions, effects);
+        int cost = reader.read_int();
+        g_operators.push_back(GlobalOperator(
+            false, i, name, move(preconditions), move(effects), cost));
+    }
+    add_goal_operator();
+    change_goal();
+
+    int num_axioms = reader.read_int();
+    for (int i = 0; i < num_axioms; ++i) {
+        vector<GlobalCondition> preconditions;
+        vector<GlobalEffect> effects;
+        reader.read_pre_post(preconditions, effects);
+        g_axioms.push_back(GlobalOperator(
+            true, -1, "", move(preconditions), move(effects), 0));
+    }
+
+    if (!reader.at_end()) {
+        cerr << "Unexpected data at the end of the binary task file." << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+}
+
+void check_no_binary_task(istream &in) {
+    // Text tasks start with "begin_version", so the first character
+    // already tells them apart.
+    for (char c : MAGIC) {
+        if (in.peek() != c)
+            return;
+        in.get();
+    }
+#if OPERATING_SYSTEM == WINDOWS
+    cerr << "Binary task files are not supported on Windows." << endl;
+    utils::exit_with(ExitCode::UNSUPPORTED);
+#else
+    cerr << "Binary tasks must be given as a regular file, "
+         << "e.g., not through a pipe." << endl;
+    utils::exit_with(ExitCode::INPUT_ERROR);
+#endif
+}
+
+#if OPERATING_SYSTEM == WINDOWS
+bool is_binary_task(int) {
+    return false;
+}
+
+void read_binary_task(int) {
+    cerr << "Binary task files are not supported on Windows." << endl;
+    utils::exit_with(ExitCode::UNSUPPORTED);
+}
+#else
+bool is_binary_task(int fd) {
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1 || !S_ISREG(file_stat.st_mode))
+        return false;
+    char magic[sizeof(MAGIC)];
+    return pread(fd, magic, sizeof(magic), 0) == sizeof(magic) &&
+           memcmp(magic, MAGIC, sizeof(MAGIC)) == 0;
+}
+
+void read_binary_task(int fd) {
+    cout << "reading binary input... [t=" << utils::g_timer << "]" << endl;
+    struct stat file_stat;
+    if (fstat(fd, &file_stat) == -1) {
+        cerr << "Could not access binary task file." << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    size_t size = file_stat.st_size;
+    void *data = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data == MAP_FAILED) {
+        cerr << "Could not map binary task file." << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    madvise(data, size, MADV_SEQUENTIAL);
+    TaskReader reader(static_cast<const char *>(data), size);
+    read_task(reader);
+    munmap(data, size);
+    cout << "done reading input! [t=" << utils::g_timer << "]" << endl;
+    initialize_global_data();
+}
+#endif
+
+static void convert_conditions(istream &in, TaskWriter &writer) {
+    int count;
+    in >> count;
+    writer.write_int(count);
+    for (int i = 0; i < 2 * count; ++i) {
+        int number;
+        in >> number;
+        writer.write_int(number);
+    }
+}
+
+// Effect conditions, var, pre and post
+static void convert_pre_post(istream &in, TaskWriter &writer) {
+    convert_conditions(in, writer);
+    for (int i = 0; i < 3; ++i) {
+        int number;
+        in >> number;
+        writer.write_int(number);
+    }
+}
+
+void convert_sas_task(istream &in, ostream &out) {
+    TaskWriter writer(out);
+    writer.write_magic();
+    writer.write_int(FORMAT_VERSION);
+
+    int version;
+    check_magic(in, "begin_version");
+    in >> version;
+    check_magic(in, "end_version");
+    if (version != PRE_FILE_VERSION) {
+        cerr << "Expected preprocessor file version " << PRE_FILE_VERSION
+             << ", got " << version << "." << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    writer.write_int(version);
+
+    bool use_metric;
+    check_magic(in, "begin_metric");
+    in >> use_metric;
+    check_magic(in, "end_metric");
+    writer.write_int(use_metric);
+
+    int num_variables;
+    in >> num_variables;
+    writer.write_int(num_variables);
+    for (int var = 0; var < num_variables; ++var) {
+        check_magic(in, "begin_variable");
+        string name;
+        int layer, range;
+        in >> name >> layer >> range >> ws;
+        writer.write_string(name);
+        writer.write_int(layer);
+        writer.write_int(range);
+        for (int value = 0; value < range; ++value) {
+            string fact_name;
+            getline(in, fact_name);
+            writer.write_string(fact_name);
+        }
+        check_magic(in, "end_variable");
+    }
+
+    int num_mutex_groups;
+    in >> num_mutex_groups;
+    writer.write_int(num_mutex_groups);
+    for (int i = 0; i < num_mutex_groups; ++i) {
+        check_magic(in, "begin_mutex_group");
+        int num_facts;
+        in >> num_facts;
+        writer.write_int(num_facts);
+        for (int j = 0; j < 2 * num_facts; ++j) {
+            int number;
+            in >> number;
+            writer.write_int(number);
+        }
+        check_magic(in, "end_mutex_group");
+    }
+
+    check_magic(in, "begin_state");
+    for (int var = 0; var < num_variables; ++var) {
+        int value;
+        in >> value;
+        writer.write_int(value);
+    }
+    check_magic(in, "end_state");
+
+    check_magic(in, "begin_goal");
+    convert_conditions(in, writer);
+    check_magic(in, "end_goal");
+
+    int num_operators;
+    in >> num_operators;
+    writer.write_int(num_operators);
+    for (int i = 0; i < num_operators; ++i) {
+        check_magic(in, "begin_operator");
+        string name;
+        in >> ws;
+        getline(in, name);
+        writer.write_string(name);
+        convert_conditions(in, writer);
+        int num_effects;
+        in >> num_effects;
+        writer.write_int(num_effects);
+        for (int j = 0; j < num_effects; ++j)
+            convert_pre_post(in, writer);
+        int cost;
+        in >> cost;
+        writer.write_int(cost);
+        check_magic(in, "end_operator");
+    }
+
+    int num_axioms;
+    in >> num_axioms;
+    writer.write_int(num_axioms);
+    for (int i = 0; i < num_axioms; ++i) {
+        check_magic(in, "begin_rule");
+        convert_pre_post(in, writer);
+        check_magic(in, "end_rule");
+    }
+
+    if (!in || !out) {
+        cerr << "Could not convert the task." << endl;
+        utils::exit_with(ExitCode::CRITICAL_ERROR);
+    }
+}
+}
@@ -0,0 +1,49 @@
+#ifndef BINARY_TASK_H
+#define BINARY_TASK_H
+
+#include <iosfwd>
+
+/*
+  Binary task format: the contents of a preprocessor output file (output.sas)
+  without any text parsing. Converting a task once with
+
+    downward --convert-task output.bin < output.sas
+
+  allows later runs to read output.bin instead (downward ... < output.bin,
+  or as task file of the server mode). The file is memory-mapped and the
+  global task data (g_variable_domain, g_operators, ...) is built directly
+  from the mapped numbers. Names still have to be copied into strings.
+
+  All numbers are 32-bit integers in native byte order, strings are stored
+  as their length followed by their characters:
+
+    header:     magic "KSTK", format version, preprocessor file version,
+                use metric
+    variables:  count, then per variable: name, axiom layer, domain size,
+                fact names (domain size many)
+    mutexes:    count, then per group: number of facts, facts (var, value)
+    init:       one value per variable
+    goal:       count, facts (var, value)
+    operators:  count, then per operator: name, number of prevail
+                conditions, prevail conditions (var, value), number of
+                effects, then per effect: number of effect conditions,
+                effect conditions (var, value), var, pre (-1 if none), post;
+                finally the cost
+    axioms:     count, then per axiom one effect as for operators
+
+  Binary tasks can only be read from regular files, and not on Windows.
+*/
+namespace binary_task {
+// Whether fd is a regular file that starts like a binary task file.
+bool is_binary_task(int fd);
+void read_binary_task(int fd);
+/*
+  Exits with an error if the stream starts like a binary task file, which
+  then could not be read as a regular file (e.g., a pipe). Otherwise,
+  nothing of a valid text task is consumed.
+*/
+void check_no_binary_task(std::istream &in);
+void convert_sas_task(std::istream &sas_in, std::ostream &out);
+}
+
+#endif
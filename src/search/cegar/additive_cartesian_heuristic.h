@@ -22,6 +22,9 @@ protected:
 
 public:
     explicit AdditiveCartesianHeuristic(const options::Options &opts);
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
 };
 }
 
@@ -15,6 +15,9 @@ protected:
 public:
     explicit ConstEvaluator(const options::Options &opts);
     virtual ~ConstEvaluator() override = default;
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
 };
 }
 
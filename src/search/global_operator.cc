@@ -124,6 +124,27 @@ GlobalOperator::GlobalOperator(istream &in, bool axiom, int index, bool goal_op)
     }
 }
 
+GlobalOperator::GlobalOperator(bool axiom, int index, const string &name,
+                               vector<GlobalCondition> &&preconditions,
+                               vector<GlobalEffect> &&effects, int cost)
+    : is_an_axiom(axiom),
+      preconditions(move(preconditions)),
+      effects(move(effects)),
+      name(name),
+      index(index) {
+    if (!is_an_axiom) {
+        this->cost = g_use_metric ? cost : 1;
+        // prevent operator applications after the goal is reached
+        this->preconditions.push_back(
+            GlobalCondition(g_variable_domain.size() - 1, 0));
+        g_min_action_cost = min(g_min_action_cost, this->cost);
+        g_max_action_cost = max(g_max_action_cost, this->cost);
+    } else {
+        this->name = "<axiom>";
+        this->cost = 0;
+    }
+}
+
 void GlobalCondition::dump() const {
     cout << g_variable_name[var] << ": " << val;
 }
@@ -63,6 +63,14 @@ class GlobalOperator {
 
 public:
     explicit GlobalOperator(std::istream &in, bool is_axiom, int index, bool goal_op = false);
+    /*
+      Operator or axiom from already parsed parts (see binary_task.h). The
+      preconditions include those of the effects, as in the operators read
+      from text.
+    */
+    GlobalOperator(bool is_axiom, int index, const std::string &name,
+                   std::vector<GlobalCondition> &&preconditions,
+                   std::vector<GlobalEffect> &&effects, int cost);
     void dump() const;
     const std::string &get_name() const {return name; }
 
@@ -148,6 +148,10 @@ void read_variables(istream &in) {
         g_fact_names.push_back(fact_names);
         check_magic(in, "end_variable");
     }
+    add_goal_variable();
+}
+
+void add_goal_variable() {
     // add extra variable
     g_variable_domain.push_back(2);
     g_variable_name.push_back("goal_var");
@@ -159,20 +163,10 @@ void read_variables(istream &in) {
 }
 
 void read_mutexes(istream &in) {
-    g_inconsistent_facts.resize(g_variable_domain.size());
-    for (size_t i = 0; i < g_variable_domain.size(); ++i)
-        g_inconsistent_facts[i].resize(g_variable_domain[i]);
-
     int num_mutex_groups;
     in >> num_mutex_groups;
 
-    /* NOTE: Mutex groups can overlap, in which case the same mutex
-       should not be represented multiple times. The current
-       representation takes care of that automatically by using sets.
-       If we ever change this representation, this is something to be
-       aware of. */
-    vector<vector<FactPair>> g_invariant_groups;
-
+    vector<vector<FactPair>> invariant_groups;
     for (int i = 0; i < num_mutex_groups; ++i) {
         check_magic(in, "begin_mutex_group");
         int num_facts;
@@ -185,8 +179,23 @@ void read_mutexes(istream &in) {
             in >> var >> value;
             invariant_group.emplace_back(var, value);
         }
-        g_invariant_groups.push_back(invariant_group);
+        invariant_groups.push_back(invariant_group);
         check_magic(in, "end_mutex_group");
+    }
+    add_mutex_groups(invariant_groups);
+}
+
+void add_mutex_groups(const vector<vector<FactPair>> &invariant_groups) {
+    g_inconsistent_facts.resize(g_variable_domain.size());
+    for (size_t i = 0; i < g_variable_domain.size(); ++i)
+        g_inconsistent_facts[i].resize(g_variable_domain[i]);
+
+    /* NOTE: Mutex groups can overlap, in which case the same mutex
+       should not be represented multiple times. The current
+       representation takes care of that automatically by using sets.
+       If we ever change this representation, this is something to be
+       aware of. */
+    for (const vector<FactPair> &invariant_group : invariant_groups) {
         for (const FactPair &fact1 : invariant_group) {
             for (const FactPair &fact2 : invariant_group) {
                 if (fact1.var != fact2.var) {
@@ -235,8 +244,14 @@ void read_operators(istream &in) {
     in >> count;
     for (int i = 0; i < count; ++i)
         g_operators.push_back(GlobalOperator(in, false, i));
-    // adding single goal operator here
-    g_operators.push_back(GlobalOperator(in, false, count, true));
+    add_goal_operator();
+}
+
+void add_goal_operator() {
+    // The goal operator does not read anything from its input.
+    istringstream no_input;
+    g_operators.push_back(
+        GlobalOperator(no_input, false, g_operators.size(), true));
 }
 
 void read_axioms(istream &in) {
@@ -244,8 +259,6 @@ void read_axioms(istream &in) {
     in >> count;
     for (int i = 0; i < count; ++i)
         g_axioms.push_back(GlobalOperator(in, true, -1));
-
-    g_axiom_evaluator = new AxiomEvaluator(TaskProxy(*g_root_task()));
 }
 
 void change_goal() {
@@ -280,6 +293,11 @@ void read_everything(istream &in) {
        have reached the end of "in". */
 
     cout << "done reading input! [t=" << utils::g_timer << "]" << endl;
+    initialize_global_data();
+}
+
+void initialize_global_data() {
+    g_axiom_evaluator = new AxiomEvaluator(TaskProxy(*g_root_task()));
 
     cout << "packing state variables..." << flush;
     assert(!g_variable_domain.empty());
@@ -462,5 +480,4 @@ void dump_pre_post_SAS(std::ostream& os, int pre, GlobalEffect eff) {
 }
 
 vector<vector<FactPair>> g_invariant_groups;
-int g_djkstra_nodes = 0;
 
@@ -39,6 +39,14 @@ void save_plan(const std::vector<const GlobalOperator *> &plan,
 int calculate_plan_cost(const std::vector<const GlobalOperator *> &plan);
 
 void read_everything(std::istream &in);
+/*
+  Parts of read_everything that do not depend on the input format. They
+  are shared with the binary task format (see binary_task.h).
+*/
+void add_goal_variable();
+void add_mutex_groups(const std::vector<std::vector<FactPair>> &invariant_groups);
+void add_goal_operator();
+void initialize_global_data();
 void dump_everything();
 
 // The following six functions are deprecated. Use task_tools.h instead.
@@ -58,7 +66,6 @@ extern const int PRE_FILE_VERSION;
 extern bool g_use_metric;
 extern int g_min_action_cost;
 extern int g_max_action_cost;
-extern int g_djkstra_nodes;
 
 // TODO: The following five belong into a new Variable class.
 extern std::vector<std::string> g_variable_name;
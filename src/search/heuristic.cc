@@ -64,6 +64,40 @@ Options Heuristic::default_options() {
     return opts;
 }
 
+bool Heuristic::is_result_cached(const GlobalState &state) {
+    return cache_h_values && heuristic_cache[state].h != NO_VALUE &&
+           !heuristic_cache[state].dirty;
+}
+
+EvaluationResult Heuristic::compute_result_in_parallel(
+    const GlobalState &state) {
+    EvaluationResult result;
+    assert(preferred_operators.empty());
+    int heuristic = compute_heuristic(state);
+    assert(heuristic == DEAD_END || heuristic >= 0);
+    if (heuristic == DEAD_END) {
+        preferred_operators.clear();
+        heuristic = EvaluationResult::INFTY;
+    }
+    result.set_count_evaluation(true);
+    result.set_h_value(heuristic);
+    /*
+      Heuristics that are shared between threads do not compute preferred
+      operators, so only touch the (then shared) set if it is filled.
+    */
+    if (!preferred_operators.empty())
+        result.set_preferred_operators(preferred_operators.pop_as_vector());
+    return result;
+}
+
+void Heuristic::store_result(const GlobalState &state,
+                             const EvaluationResult &result) {
+    if (cache_h_values) {
+        int heuristic = result.is_infinite() ? DEAD_END : result.get_h_value();
+        heuristic_cache[state] = HEntry(heuristic, false);
+    }
+}
+
 EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
     EvaluationResult result;
 
@@ -74,8 +108,7 @@ EvaluationResult Heuristic::compute_result(EvaluationContext &eval_context) {
 
     int heuristic = NO_VALUE;
 
-    if (!calculate_preferred && cache_h_values &&
-        heuristic_cache[state].h != NO_VALUE && !heuristic_cache[state].dirty) {
+    if (!calculate_preferred && is_result_cached(state)) {
         heuristic = heuristic_cache[state].h;
         result.set_count_evaluation(false);
     } else {
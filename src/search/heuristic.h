@@ -101,6 +101,30 @@ public:
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override;
 
+    /*
+      Evaluation of several states in parallel (see
+      ParallelHeuristicEvaluator):
+
+      CONCURRENT: compute_heuristic() only reads the heuristic's data and
+        may be called from several threads at the same time.
+      PER_THREAD: every thread needs its own instance of the heuristic,
+        created from the same configuration.
+      SERIAL: the heuristic cannot be evaluated in parallel, e.g., because
+        it keeps per-state information that is updated during the search.
+    */
+    enum class ParallelEvaluation {CONCURRENT, PER_THREAD, SERIAL};
+    virtual ParallelEvaluation get_parallel_evaluation() const {
+        return ParallelEvaluation::PER_THREAD;
+    }
+    /*
+      compute_result() without the cache of heuristic values, for parallel
+      evaluation. store_result() caches such a result like compute_result()
+      would; it must not be called from several threads at the same time.
+    */
+    bool is_result_cached(const GlobalState &state);
+    EvaluationResult compute_result_in_parallel(const GlobalState &state);
+    void store_result(const GlobalState &state, const EvaluationResult &result);
+
     std::string get_description() const;
     bool is_h_dirty(GlobalState &state) {
         return heuristic_cache[state].dirty;
@@ -11,6 +11,9 @@ protected:
 public:
     BlindSearchHeuristic(const options::Options &options);
     ~BlindSearchHeuristic();
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
 };
 }
 
@@ -10,6 +10,9 @@ protected:
 public:
     GoalCountHeuristic(const options::Options &options);
     ~GoalCountHeuristic();
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
 };
 }
 
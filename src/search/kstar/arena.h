@@ -0,0 +1,44 @@
+#ifndef KSTAR_ARENA_H
+#define KSTAR_ARENA_H
+
+#include "../algorithms/segmented_vector.h"
+
+/*
+  Arena is the storage of the edges and path graph nodes of K*. Entries are
+  never moved, and they are referred to by their 32-bit index instead of by
+  (shared) pointers. This keeps path graph nodes small and cheap to copy.
+  Entries cannot be removed individually; clear() removes all entries at once
+  but keeps the memory for reuse.
+*/
+namespace kstar {
+template<typename Entry>
+class Arena {
+    segmented_vector::SegmentedVector<Entry> entries;
+
+public:
+    Arena() = default;
+
+    int add(const Entry &entry) {
+        entries.push_back(entry);
+        return entries.size() - 1;
+    }
+
+    Entry &operator[](int id) {
+        return entries[id];
+    }
+
+    const Entry &operator[](int id) const {
+        return entries[id];
+    }
+
+    int size() const {
+        return entries.size();
+    }
+
+    void clear() {
+        entries.resize(0);
+    }
+};
+}
+
+#endif
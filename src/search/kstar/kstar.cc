@@ -5,6 +5,8 @@
 #include "../search_engines/search_common.h"
 #include "../utils/util.h"
 #include "../utils/countdown_timer.h"
+#include "../utils/system.h"
+#include "../utils/thread_pool.h"
 #include "util.h"
 
 using namespace top_k_eager_search;
@@ -15,45 +17,150 @@ KStar::KStar(const options::Options &opts) : TopKEagerSearch(opts),
         optimal_solution_cost(-1),
         simple_plans_only(opts.get<bool>("simple_plans_only")),
         dump_states(opts.get<bool>("dump_states")),
-        dump_json(opts.contains("json_file_to_dump")),
-        json_filename(""),
         num_node_expansions(0),
-        djkstra_initialized(false) {
-    if (dump_json) {
-        json_filename = opts.get<string>("json_file_to_dump");
-    }
+        djkstra_initialized(false),
+        queue_djkstra(create_path_graph_queue(
+                          PathGraphQueueType(opts.get_enum("pg_queue")))),
+        pg_root(-1),
+        pg_goal_state(StateID::no_state),
+        pg_epoch(0),
+        unexpanded_pg_node(-1),
+        stats_file(opts.contains("stats_file") ?
+                   opts.get<string>("stats_file") : ""),
+        progress_interval(opts.get<double>("progress_interval")),
+        next_progress_time(progress_interval) {
+    astar_timer.stop();
+    astar_timer.reset();
     pg_succ_generator =
             unique_ptr<SuccessorGenerator>(new SuccessorGenerator(
+                                                            saps,
+                                                            tree_heap_nodes,
                                                             tree_heap,
-                                                            incomming_heap,
-                                                            parent_node,
-                                                            cross_edge,
+                                                            in_heap_nodes,
                                                             &state_registry));
     plan_reconstructor =  unique_ptr<PlanReconstructor>(new PlanReconstructor(
-                                                       parent_node,
-                                                       cross_edge,
+                                                       pg_nodes,
+                                                       sidetrack_lists,
+                                                       saps,
                                                        goal_state,
                                                        &state_registry,
-                                                       &search_space, opts.get<bool>("skip_reorderings"), opts.get<bool>("dump_plans"), verbosity));
+                                                       &search_space, opts.get<bool>("skip_reorderings"),
+                                                       opts.get<bool>("verify_reorderings"), opts.get<bool>("dump_plans"), verbosity,
+                                                       statistics));
+    add_plan_sinks(opts);
+    create_extraction_pipeline(opts);
+}
 
+void KStar::create_extraction_pipeline(const options::Options &opts) {
+    int num_threads = opts.get<int>("extraction_threads");
+    if (num_threads == 1)
+        return;
+    if (opts.get<bool>("dump_plans")) {
+        // Dumping plans registers states, which must not happen while
+        // workers extract plans
+        cout << "Plans are dumped, extracting plans in the search thread"
+             << endl;
+        return;
+    }
+    if (num_threads == 0)
+        num_threads = utils::get_hardware_concurrency();
+    // The search thread prepares and commits the plans
+    int num_workers = max(1, num_threads - 1);
+    extraction_pipeline = unique_ptr<PlanExtractionPipeline>(
+        new PlanExtractionPipeline(*plan_reconstructor, simple_plans_only,
+                                   num_workers));
+    cout << "Extracting plans with " << num_workers << " worker threads"
+         << endl;
+}
+
+void KStar::add_plan_sinks(const options::Options &opts) {
+    if (opts.get<bool>("save_plan_files")) {
+        plan_reconstructor->add_plan_sink(
+            unique_ptr<PlanSink>(new PlanFilesSink()));
+    }
+    if (opts.contains("json_file_to_dump") ||
+        opts.contains("jsonl_file_to_dump")) {
+        pddl_strings = unique_ptr<PddlStrings>(
+            new PddlStrings(state_registry.get_task(), g_operators));
+    }
+    if (opts.contains("json_file_to_dump")) {
+        plan_reconstructor->add_plan_sink(unique_ptr<PlanSink>(
+            new JsonPlansSink(opts.get<string>("json_file_to_dump"),
+                              state_registry, *pddl_strings, dump_states,
+                              opts.get<bool>("state_table"))));
+    }
+    if (opts.contains("jsonl_file_to_dump")) {
+        plan_reconstructor->add_plan_sink(unique_ptr<PlanSink>(
+            new JsonLinesPlanSink(opts.get<string>("jsonl_file_to_dump"),
+                                  state_registry, *pddl_strings, dump_states,
+                              opts.get<bool>("state_table"))));
+    }
+    if (opts.contains("binary_file_to_dump")) {
+        plan_reconstructor->add_plan_sink(unique_ptr<PlanSink>(
+            new BinaryPlanLogSink(opts.get<string>("binary_file_to_dump"))));
+    }
 }
 
 void KStar::search() {
     initialize();
+    statistics.take_memory_snapshot("search_start");
+    run_search(false);
+}
+
+bool KStar::continue_search(int num_plans, double quality_bound) {
+    if (status == FAILED) {
+        // All plans have been found already
+        return true;
+    }
+    if (status != SOLVED)
+        return false;
+    if (quality_bound >= 1.0 && quality_bound != this->quality_bound) {
+        if (quality_bound > this->quality_bound && pruned_by_bound)
+            return false;
+        bound = (int) ( (optimal_solution_cost * quality_bound) + 0.00001) + 2;
+    }
+    this->number_of_plans = num_plans;
+    this->quality_bound = quality_bound;
+    if (enough_plans_found())
+        return true;
+
+    cout << "Continuing K* with K=" << num_plans << ", q=" << quality_bound
+         << endl;
+    if (unexpanded_pg_node != -1) {
+        expand_pg_node(unexpanded_pg_node);
+        unexpanded_pg_node = -1;
+    }
+    // A* has not changed, so the search continues with Dijkstra
+    status = INTERRUPTED;
+    run_search(true);
+    return true;
+}
+
+void KStar::run_search(bool resume_with_djkstra) {
     utils::CountdownTimer timer(max_time);
     while (status == IN_PROGRESS || status == INTERRUPTED
            || status == FIRST_PLAN_FOUND) {
-        status = step();
-        if (timer.is_expired()) {
-            cout << "Time limit reached. Aborting search." << endl;
-            status = TIMEOUT;
-            break;
+        if (resume_with_djkstra) {
+            resume_with_djkstra = false;
+        } else {
+            astar_timer.resume();
+            statistics.start_phase(SearchPhase::ASTAR);
+            status = step();
+            statistics.end_phase();
+            astar_timer.stop();
+            report_progress();
+            if (timer.is_expired()) {
+                cout << "Time limit reached. Aborting search." << endl;
+                status = TIMEOUT;
+                break;
+            }
         }
         // First solution found. Add R to path graph, perform Dijkstra
         if (status == FIRST_PLAN_FOUND) {
             if (verbosity >= Verbosity::NORMAL) {
                 cout << "[KSTAR] First plan is found" << endl;
             }            
+            statistics.take_memory_snapshot("first_plan");
             if (djkstra_search()) {
                 if (verbosity >= Verbosity::NORMAL) {
                     cout << "[KSTAR] Dijkstra search finished successfully, found all required plans" << endl;
@@ -75,7 +182,7 @@ void KStar::search() {
             if (verbosity >= Verbosity::NORMAL) {
                 cout << "[KSTAR] status INTERRUPTED" << endl;
             }
-            // if (!open_list->empty() && !queue_djkstra.empty()) {
+            // if (!open_list->empty() && !queue_djkstra->empty()) {
             //     // if enough nodes expanded do Dijkstra search
             //     if (verbosity >= Verbosity::NORMAL) {
             //         cout << "[KSTAR] open list not empty, dijkstra queue not empty" << endl;
@@ -102,7 +209,7 @@ void KStar::search() {
             //         resume_astar();
             //     }
             // }
-            // if (!open_list->empty() && queue_djkstra.empty()) {
+            // if (!open_list->empty() && queue_djkstra->empty()) {
             //     if (verbosity >= Verbosity::NORMAL) {
             //         cout << "[KSTAR] open list not empty, dijkstra queue empty, resuming Astar" << endl;
             //     }
@@ -166,26 +273,44 @@ void KStar::search() {
 
     if (plan_reconstructor->number_of_plans_found() == 0 && first_plan_found) {
         // There has to be at least one plan
-        GlobalState g = state_registry.lookup_state(goal_state);
-
-        Plan plan;
-        search_space.trace_path(g, plan);
-        plan_reconstructor->add_plan_explicit_no_check(plan);
+        plan_reconstructor->set_goal_state(goal_state);
+        plan_reconstructor->add_plan_explicit_no_check();
         set_optimal_plan_cost(plan_reconstructor->get_last_added_plan_cost());
         inc_optimal_plans_count(plan_reconstructor->get_last_added_plan_cost());
         statistics.inc_plans_found();
     }
 
-    if (dump_json) {
-        ofstream os(json_filename.c_str());
-        plan_reconstructor->dump_plans_json(os, dump_states);
-    }
+    plan_reconstructor->finish_plan_sinks();
+    statistics.take_memory_snapshot("search_end");
 
+    cout << "A* search time: " << astar_timer << endl;
     cout << "Actual search time: " << timer
          << " [t=" << utils::g_timer << "]" << endl;
+    if (!stats_file.empty())
+        write_stats_file();
+}
+
+void KStar::report_progress() {
+    if (progress_interval <= 0 ||
+        statistics.get_elapsed_time() < next_progress_time)
+        return;
+    statistics.print_progress_line();
+    // Skip the intervals that have passed without a progress line
+    while (next_progress_time <= statistics.get_elapsed_time())
+        next_progress_time += progress_interval;
+}
+
+void KStar::write_stats_file() const {
+    ofstream file(stats_file);
+    statistics.dump_json(file);
+    if (!file) {
+        cerr << "Could not write the statistics to " << stats_file << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
 }
 
 bool KStar::enough_nodes_expanded() {
+    statistics.inc_termination_checks();
     if (open_list->empty()) {
         if (verbosity >= Verbosity::VERBOSE) {
             cout << "[KSTAR] Open list is empty" << endl;
@@ -217,10 +342,11 @@ void KStar::resume_astar() {
 }
 
 void KStar::update_most_expensive_succ() {
-    if(queue_djkstra.empty())
+    if(queue_djkstra->empty())
         return;
-    Node n = queue_djkstra.top();
-    most_expensive_successor = n.g + pg_succ_generator->get_max_successor_delta(n, pg_root);
+    const Node &n = pg_nodes[queue_djkstra->top().second];
+    most_expensive_successor = n.g + pg_succ_generator->get_max_successor_delta(
+        n, goal_state);
 }
 
 void KStar::set_optimal_plan_cost(int plan_cost) {
@@ -242,7 +368,7 @@ void KStar::initialize_djkstra() {
         g.dump_pddl();
     }
     init_tree_heap(g);
-    if (tree_heap[g].empty()) {
+    if (tree_heap[g].root == TreeHeap::NO_NODE) {
         return;
     }
     // Generate root of path graph
@@ -250,24 +376,24 @@ void KStar::initialize_djkstra() {
         cout << "[KSTAR] Generating root of path graph" << endl;
     }
 
-    Sap sap = make_shared<StateActionPair>(StateID::no_state,
-                                           goal_state, nullptr,
-                                           &state_registry, &search_space);
-    pg_root = make_shared<Node>(0, sap, StateID::no_state);
-    pg_root->id = g_djkstra_nodes;
-    ++g_djkstra_nodes;
+    pg_root = pg_nodes.add(Node(0, -1, StateID::no_state));
+    pg_goal_state = goal_state;
     if (verbosity >= Verbosity::NORMAL) {
         cout << "[KSTAR] Adding the first plan" << endl;
     }    
-    bool added = plan_reconstructor->add_plan(*pg_root, simple_plans_only);
+    bool added = plan_reconstructor->add_plan(pg_root, simple_plans_only);
     // cout << "Plan was added: " << added << endl; 
     assert(added); // The first plan should always be successfully added
     set_optimal_plan_cost(plan_reconstructor->get_last_added_plan_cost());
     inc_optimal_plans_count(plan_reconstructor->get_last_added_plan_cost());
     statistics.inc_plans_found();
     Node successor;
-    pg_succ_generator->get_successor_pg_root(pg_root, successor);
-    queue_djkstra.push(successor);
+    pg_succ_generator->get_successor_pg_root(pg_root, pg_nodes[pg_root],
+                                             goal_state, successor);
+    NodeID successor_id = pg_nodes.add(successor);
+    pg_nodes[pg_root].cross_child = successor_id;
+    expanded_pg_nodes.push_back(pg_root);
+    queue_djkstra->push(successor.g, successor_id);
     statistics.inc_total_djkstra_generations();
     djkstra_initialized = true;
 }
@@ -292,10 +418,10 @@ bool KStar::enough_plans_found_topq() const {
 
 // init the neccessary tree heaps for the successor generation
 // of s that is tree_heap[s] (obviously) and from (for the cross edge)
-void KStar::init_tree_heaps(Node node) {
+void KStar::init_tree_heaps(const Node &node) {
     GlobalState s = state_registry.lookup_state(node.heap_state);
     init_tree_heap(s);
-    GlobalState from  = state_registry.lookup_state(node.sap->from);
+    GlobalState from  = state_registry.lookup_state(saps[node.sap].from);
     init_tree_heap(from);
 }
 
@@ -304,12 +430,139 @@ void KStar::throw_everything() {
     if (verbosity >= Verbosity::NORMAL) {
         cout << "[KSTAR] Before throwing everything we had " << plan_reconstructor->number_of_plans_found() << " plans" << endl;
     }
+    if (extraction_pipeline)
+        extraction_pipeline->clear();
     plan_reconstructor->clear();    
 
     num_node_expansions = 0;
     statistics.reset_plans_found();
     statistics.reset_opt_found();
-    queue_djkstra = std::priority_queue<Node>();
+    queue_djkstra->clear();
+    pg_nodes.clear();
+    sidetrack_lists.clear();
+    pg_root = -1;
+    pg_goal_state = StateID::no_state;
+    expanded_pg_nodes.clear();
+    unexpanded_pg_node = -1;
+}
+
+// The cross edge of the root leads to H_T(goal), all other cross edges
+// of a node with edge (u,v) to H_T(u)
+StateID KStar::get_cross_edge_source(const Node &node) const {
+    if (node.sap == -1)
+        return pg_goal_state;
+    return saps[node.sap].from;
+}
+
+// A node is stale if it or one of its ancestors is. The result is cached in
+// the nodes on the way up until the epoch changes.
+bool KStar::is_stale(NodeID node_id) {
+    stale_check_path.clear();
+    bool stale = false;
+    for (NodeID current = node_id; current != -1;
+         current = pg_nodes[current].parent) {
+        const Node &node = pg_nodes[current];
+        if (node.stale) {
+            stale = true;
+            break;
+        }
+        if (node.valid_epoch == pg_epoch)
+            break;
+        stale_check_path.push_back(current);
+    }
+    for (NodeID id : stale_check_path) {
+        if (stale)
+            pg_nodes[id].stale = true;
+        else
+            pg_nodes[id].valid_epoch = pg_epoch;
+    }
+    return stale;
+}
+
+/*
+  A* may have changed the tree heaps since the last Dijkstra run. The heap
+  successors of a node never change (heaps are persistent), but its cross
+  edge has to point to the current root of H_T(u). For every expanded node
+  where this changed, the old cross child (and thus its subtree) becomes
+  stale and a new cross child is generated.
+*/
+void KStar::update_path_graph() {
+    vector<NodeID> changed;
+    for (NodeID id : expanded_pg_nodes) {
+        Node &node = pg_nodes[id];
+        GlobalState from = state_registry.lookup_state(get_cross_edge_source(node));
+        init_tree_heap(from);
+        int old_root = TreeHeap::NO_NODE;
+        if (node.cross_child != -1)
+            old_root = pg_nodes[node.cross_child].tree_heap_node;
+        if (tree_heap[from].root != old_root) {
+            if (node.cross_child != -1)
+                pg_nodes[node.cross_child].stale = true;
+            changed.push_back(id);
+        }
+    }
+    if (changed.empty())
+        return;
+    ++pg_epoch;
+    expanded_pg_nodes.erase(
+        remove_if(expanded_pg_nodes.begin(), expanded_pg_nodes.end(),
+                  [this](NodeID id) {return is_stale(id); }),
+        expanded_pg_nodes.end());
+
+    int num_regenerated = 0;
+    for (NodeID id : changed) {
+        if (is_stale(id))
+            continue;
+        Node &node = pg_nodes[id];
+        vector<Node> successors;
+        if (id == pg_root) {
+            Node successor;
+            pg_succ_generator->get_successor_pg_root(pg_root, node,
+                                                     pg_goal_state, successor);
+            successors.push_back(successor);
+        } else {
+            pg_succ_generator->add_cross_edge(id, node, successors);
+        }
+        for (Node &succ : successors) {
+            succ.regenerated = true;
+            set_sidetracks(node, succ);
+            node.cross_child = pg_nodes.add(succ);
+            queue_djkstra->push(succ.g, node.cross_child);
+            statistics.inc_total_djkstra_generations();
+            ++num_regenerated;
+        }
+    }
+    if (verbosity >= Verbosity::NORMAL) {
+        cout << "[KSTAR] Regenerated " << num_regenerated
+             << " cross edges of the path graph" << endl;
+    }
+}
+
+// Following the cross edge of a node makes its edge a sidetrack of the plan
+void KStar::set_sidetracks(const Node &node, Node &succ) {
+    if (succ.is_cross_edge && node.sap != -1) {
+        succ.sidetracks = sidetrack_lists.add(
+            SidetrackCell(node.sap, node.sidetracks));
+    } else {
+        succ.sidetracks = node.sidetracks;
+    }
+}
+
+void KStar::expand_pg_node(NodeID node_id) {
+    Node &node = pg_nodes[node_id];
+    init_tree_heaps(node);
+    std::vector<Node> successors;
+    pg_succ_generator->get_successors(node_id, node, successors);
+    for (Node &succ : successors) {
+        succ.regenerated = node.regenerated;
+        set_sidetracks(node, succ);
+        NodeID succ_id = pg_nodes.add(succ);
+        if (succ.is_cross_edge)
+            node.cross_child = succ_id;
+        queue_djkstra->push(succ.g, succ_id);
+        statistics.inc_total_djkstra_generations();
+    }
+    expanded_pg_nodes.push_back(node_id);
 }
 
 // Djkstra search on path graph P(G) returns true if enough plans have been found
@@ -317,70 +570,123 @@ bool KStar::djkstra_search() {
     if (verbosity >= Verbosity::NORMAL) {
         std::cout << "[KSTAR] Switching to djkstra search on path graph" << std::endl;
     }
-    // When Djkstra restarts remove everything from its last iteration
-    throw_everything();
-    statistics.inc_djkstra_runs();
+    // The search resumes where it stopped unless the path graph is rooted
+    // at a different goal state now
+    if (djkstra_initialized && goal_state != pg_goal_state)
+        throw_everything();
+    statistics.inc_djkstra_runs(next_node_f);
+    SearchPhaseTimer phase_timer(statistics, SearchPhase::DJKSTRA);
+    if (djkstra_initialized)
+        update_path_graph();
     initialize_djkstra();
     if (verbosity >= Verbosity::NORMAL) {
         dump_dot();
     }
-    int succ_gens = 0;
     int exps = 0;
     if (verbosity >= Verbosity::NORMAL) {
         cout << "[KSTAR] Start reconstructing plans using Dijkstra" << endl;
     }
-    while (!queue_djkstra.empty()) {
-        Node node = queue_djkstra.top();
+    while (!queue_djkstra->empty()) {
+        NodeID node_id = queue_djkstra->top().second;
+        if (is_stale(node_id)) {
+            queue_djkstra->pop();
+            continue;
+        }
         if (!enough_nodes_expanded()) {
             if (verbosity >= Verbosity::NORMAL) {
                 cout << "[KSTAR] Not enough nodes are expanded by Astar" << endl;
             }
-            return false;
+            return extraction_pipeline && commit_extracted_plans(0);
         }
-        queue_djkstra.pop();
-
-        //notify_expand(node, &state_registry, num_node_expansions);
-        if (verbosity >= Verbosity::NORMAL) {
-            cout << "[KSTAR] Getting a plan for the node " << node.id;
-        }
-        if (plan_reconstructor->add_plan(node, simple_plans_only)) {
-            if (verbosity >= Verbosity::NORMAL) {
-                cout << "  added" << endl;
-            }
-            inc_optimal_plans_count(plan_reconstructor->get_last_added_plan_cost());
-            statistics.inc_plans_found();
+        if (extraction_pipeline) {
+            // Make room for the plan of the node before popping it
+            if (commit_extracted_plans(extraction_pipeline->get_max_pending() - 1))
+                return true;
+            queue_djkstra->pop();
+            PlanCandidate candidate;
+            if (plan_reconstructor->prepare_candidate(
+                    node_id, simple_plans_only, candidate))
+                extraction_pipeline->submit(move(candidate));
         } else {
+            queue_djkstra->pop();
             if (verbosity >= Verbosity::NORMAL) {
-                cout << "  Duplicate, not added" << endl;
+                cout << "[KSTAR] Getting a plan for the node " << node_id;
             }
-        }
-        if (enough_plans_found()) {
-            if (verbosity >= Verbosity::NORMAL) {
-                cout << "Number of plans found: " << plan_reconstructor->number_of_plans_found() << endl;
+            if (count_plan(plan_reconstructor->add_plan(
+                               node_id, simple_plans_only))) {
+                unexpanded_pg_node = node_id;
+                return true;
             }
-            return true;
         }
         exps++;
-        init_tree_heaps(node);
-        std::vector<Node> successors;
-        pg_succ_generator->get_successors(node, successors);
-        succ_gens += successors.size();
-        for (auto succ : successors) {
-            queue_djkstra.push(succ);
-            statistics.inc_total_djkstra_generations();
-        }
+        expand_pg_node(node_id);
+        report_progress();
         if (verbosity >= Verbosity::NORMAL) {
-            if (succ_gens % 1000 == 0) {
-                std::cout << "[KSTAR] Djkstra ["<< exps << " expanded, "<< succ_gens << " generated]" << std::endl;
+            if (exps % 1000 == 0) {
+                std::cout << "[KSTAR] Djkstra ["<< exps << " expanded, "
+                          << pg_nodes.size() << " generated]" << std::endl;
             }
         }
     }
+    if (extraction_pipeline && commit_extracted_plans(0))
+        return true;
     if (verbosity >= Verbosity::NORMAL) {
         cout << "Number of plans found: " << plan_reconstructor->number_of_plans_found() << endl;
     }
     return false;
 }
 
+// Counts an added plan, returns true if enough plans have been found
+bool KStar::count_plan(bool added) {
+    if (added) {
+        if (verbosity >= Verbosity::NORMAL) {
+            cout << "  added" << endl;
+        }
+        inc_optimal_plans_count(plan_reconstructor->get_last_added_plan_cost());
+        statistics.inc_plans_found();
+    } else {
+        if (verbosity >= Verbosity::NORMAL) {
+            cout << "  Duplicate, not added" << endl;
+        }
+    }
+    if (enough_plans_found()) {
+        if (verbosity >= Verbosity::NORMAL) {
+            cout << "Number of plans found: " << plan_reconstructor->number_of_plans_found() << endl;
+        }
+        return true;
+    }
+    return false;
+}
+
+/*
+  Commits the extracted plans in the order in which their nodes were popped,
+  waiting for the workers while more than max_pending plans are pending.
+  Returns true as soon as enough plans have been found. The remaining
+  plans stay pending and are committed first if the search is continued.
+*/
+bool KStar::commit_extracted_plans(size_t max_pending) {
+    while (extraction_pipeline->get_num_pending() > max_pending ||
+           extraction_pipeline->is_next_done()) {
+        PlanCandidate candidate = extraction_pipeline->take_next();
+        if (verbosity >= Verbosity::NORMAL) {
+            cout << "[KSTAR] Getting a plan for the node " << candidate.node;
+        }
+        bool added;
+        {
+            SearchPhaseTimer phase_timer(statistics,
+                                         SearchPhase::PLAN_EXTRACTION);
+            added = plan_reconstructor->commit_candidate(candidate);
+        }
+        if (count_plan(added)) {
+            // Nothing may run in the background while A* or the caller
+            // change the search space
+            extraction_pipeline->wait_until_idle();
+            return true;
+        }
+    }
+    return false;
+}
+
 void KStar::inc_optimal_plans_count(int plan_cost) {
     if (plan_cost == optimal_solution_cost && plan_cost >= 0) {
         statistics.inc_opt_plans();
@@ -399,17 +705,23 @@ void KStar::dump_path_graph() {
         StateID id = *it;
         GlobalState s = state_registry.lookup_state(id);
         begin_subgraph(s.get_state_tuple(), stream);
-        for (size_t i = 0; i  < tree_heap[s].size(); ++i){
-            Sap sap = tree_heap[s][i];
-            std::string id = get_sap_id(sap, s);
-            std::string label = get_sap_label(sap);
+        vector<int> heap_nodes;
+        tree_heap_nodes.collect(tree_heap[s].root, heap_nodes);
+        for (int heap_node : heap_nodes) {
+            int in_node = tree_heap_nodes[heap_node].value;
+            SapID sap = in_heap_nodes[in_node].value;
+            std::string id = get_sap_id(saps[sap], s, &state_registry);
+            std::string label = get_sap_label(saps[sap], &state_registry);
             Node node(0, sap, s.get_id());
+            node.tree_heap_node = heap_node;
+            node.in_heap_node = in_node;
             vector<Node> successors;
-            pg_succ_generator->get_successors(node, successors, true);
+            pg_succ_generator->get_successors(-1, node, successors);
             for (auto& succ : successors) {
                 GlobalState heap_state =
                         state_registry.lookup_state(succ.heap_state);
-                std::string succ_id = get_sap_id(succ.sap, heap_state);
+                std::string succ_id = get_sap_id(saps[succ.sap], heap_state,
+                                                 &state_registry);
                 add_edge(id, succ_id, std::to_string(succ.g), stream);
             }
         }
@@ -438,12 +750,15 @@ void KStar::dump_dot() const {
         stream << "label=\"#"<< id.hash() << "\\n" << "s="<< state_label(s) << "\\n";
         stream << "\" ]\n";
 
-        for (Sap sap: incomming_heap[s]) {
-            node_stream << id.hash() << "  ->  " << sap->get_from_state().get_id().hash();
-            node_stream <<" [ label=\"" << sap->op->get_name();
-            node_stream << "/"<< sap->op->get_cost();
+        vector<SapID> incoming_edges;
+        get_incoming_edges(s, incoming_edges);
+        for (SapID sap_id : incoming_edges) {
+            const StateActionPair &sap = saps[sap_id];
+            node_stream << id.hash() << "  ->  " << sap.from.hash();
+            node_stream <<" [ label=\"" << sap.get_op()->get_name();
+            node_stream << "/"<< sap.get_op()->get_cost();
             node_stream << "\"";
-            if (node_info.parent_state_id == sap->get_from_state().get_id()) {
+            if (node_info.parent_state_id == sap.from) {
                 node_stream << " style=\"dashed\" color=\"#A9A9A9 \"";
             }
             node_stream << " ]\n";
@@ -495,33 +810,62 @@ static SearchEngine *_parse(OptionParser &parser) {
 
     top_k_eager_search::add_top_k_option(parser);
 
+    parser.add_option<bool>("verify_reorderings",
+        "With skip_reorderings, compare the operators of plans with equal "
+        "fingerprints exactly instead of relying on the fingerprints alone",
+        "false");
     parser.add_option<bool>("dump_plans", "Print plans", "false");
     parser.add_option<bool>("dump_states", "Dump states to json", "false");
+    parser.add_option<bool>("state_table",
+        "With dump_states, write every state once into a table and refer to "
+        "the states of the plans by their index in the table "
+        "(see kstar/plan_sink.h)",
+        "false");
     
     parser.add_option<string>("json_file_to_dump",
         "A path to the json file to use for dumping",
         OptionParser::NONE);
-
-    vector<string> verbosity_levels;
-    vector<string> verbosity_level_docs;
-    verbosity_levels.push_back("silent");
-    verbosity_level_docs.push_back(
-        "silent: no output during construction, only starting and final "
-        "statistics");
-    verbosity_levels.push_back("normal");
-    verbosity_level_docs.push_back(
-        "normal: basic output during construction, starting and final "
-        "statistics");
-    verbosity_levels.push_back("verbose");
-    verbosity_level_docs.push_back(
-        "verbose: full output during construction, starting and final "
-        "statistics");
+    parser.add_option<string>("jsonl_file_to_dump",
+        "A path to a file to stream the plans to as they are found, "
+        "one json object per line",
+        OptionParser::NONE);
+    parser.add_option<string>("binary_file_to_dump",
+        "A path to a file to stream the plans to as they are found, "
+        "in a compact binary format (see kstar/plan_sink.h)",
+        OptionParser::NONE);
+    parser.add_option<int>("extraction_threads",
+        "Number of threads that extract plans while the Dijkstra search "
+        "goes on (0: one per core). Plans are found and written in the same "
+        "order as with serial extraction. Plans are always extracted "
+        "serially with dump_plans.",
+        "1",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>("save_plan_files",
+        "Save every plan to its own file in found_plans", "true");
+    parser.add_option<string>("stats_file",
+        "A path to a json file for the search statistics (phase times, "
+        "counters, Dijkstra runs per f layer and memory snapshots), "
+        "written at the end of the search",
+        OptionParser::NONE);
+    parser.add_option<double>("progress_interval",
+        "Print a line with the current statistics every that many "
+        "seconds (0: never)",
+        "0");
+
+    vector<string> pg_queue_types;
+    vector<string> pg_queue_type_docs;
+    pg_queue_types.push_back("bucket");
+    pg_queue_type_docs.push_back(
+        "bucket: bucket-based queue, switching to a heap if the path "
+        "graph costs are spread too widely");
+    pg_queue_types.push_back("heap");
+    pg_queue_type_docs.push_back("heap: binary heap");
     parser.add_enum_option(
-        "verbosity",
-        verbosity_levels,
-        "Option to specify the level of verbosity.",
-        "silent",
-        verbosity_level_docs);
+        "pg_queue",
+        pg_queue_types,
+        "Priority queue of the Dijkstra search on the path graph.",
+        "bucket",
+        pg_queue_type_docs);
 
     top_k_eager_search::add_pruning_option(parser);
     add_simple_plans_only_option(parser);
@@ -2,12 +2,17 @@
 #define KSTAR_KSTAR_H
 
 #include "successor_generator.h"
+#include "path_graph_queue.h"
+#include "pddl_strings.h"
+#include "plan_extraction_pipeline.h"
 #include "plan_reconstructor.h"
 #include "kstar_types.h"
 
 #include "../search_engines/top_k_eager_search.h"
+#include "../utils/timer.h"
 
 #include <memory>
+#include <string>
 
 namespace kstar {
 
@@ -17,28 +22,62 @@ protected:
     int optimal_solution_cost;
     bool simple_plans_only;
     bool dump_states;
-    bool dump_json;
-    std::string json_filename;
 
     int num_node_expansions;
     bool djkstra_initialized;
-    std::priority_queue<Node> queue_djkstra;
-    std::unordered_map<Node, Node> parent_node;
-    std::unordered_set<Edge> cross_edge;
+    // Time spent in A* steps, excluding the path graph search
+    utils::Timer astar_timer;
+    // Nodes of the path graph. Nodes refer to their parents, which is all
+    // we need to trace back the sidetrack sequence of a node.
+    NodeArena pg_nodes;
+    SidetrackArena sidetrack_lists;
+    std::unique_ptr<PathGraphQueue> queue_djkstra;
+    // Only built if plans are dumped as JSON. Declared before the
+    // reconstructor, whose plan sinks refer to it.
+    std::unique_ptr<PddlStrings> pddl_strings;
     std::unique_ptr<PlanReconstructor> plan_reconstructor;
+    // Extracts plans in worker threads; null if plans are extracted in the
+    // search thread
+    std::unique_ptr<PlanExtractionPipeline> extraction_pipeline;
     std::shared_ptr<SuccessorGenerator> pg_succ_generator;
     // root of the path graph
-    shared_ptr<Node> pg_root;
+    NodeID pg_root;
+    // The goal state the path graph was built for
+    StateID pg_goal_state;
+    // Expanded path graph nodes that are not known to be stale. Their cross
+    // edges are checked for changes whenever the Dijkstra search resumes.
+    std::vector<NodeID> expanded_pg_nodes;
+    // Incremented whenever nodes have become stale, see is_stale()
+    int pg_epoch;
+    // Node whose plan ended the last Dijkstra search; it is expanded when
+    // the search is continued. With the extraction pipeline, nodes are
+    // expanded right away and the pending plans are committed instead.
+    NodeID unexpanded_pg_node;
+    std::vector<NodeID> stale_check_path;
+    // Statistics are written to this file after every search, if given
+    std::string stats_file;
+    // Seconds between progress lines, 0 for none
+    double progress_interval;
+    double next_progress_time;
+    void report_progress();
+    void write_stats_file() const;
+    void add_plan_sinks(const options::Options &opts);
+    void create_extraction_pipeline(const options::Options &opts);
+    bool count_plan(bool added);
+    bool commit_extracted_plans(size_t max_pending);
+    void run_search(bool resume_with_djkstra);
     void initialize_djkstra();
     // djkstra search return true if k solutions have been found and false otherwise
     bool djkstra_search();
     bool enough_nodes_expanded();
     void resume_astar();
-    void init_tree_heaps(Node node);
-    vector<Sap> djkstra_traceback(Node& top_pair);
-    vector<Sap> compute_sidetrack_seq(Node& top_pair, vector<Sap>& path);
+    void init_tree_heaps(const Node &node);
     void throw_everything();
-    void add_plan(Node& p);
+    StateID get_cross_edge_source(const Node &node) const;
+    bool is_stale(NodeID node);
+    void update_path_graph();
+    void set_sidetracks(const Node &node, Node &succ);
+    void expand_pg_node(NodeID node_id);
     bool enough_plans_found() const;
     bool enough_plans_found_topk() const;
     bool enough_plans_found_topq() const;
@@ -51,6 +90,14 @@ protected:
 public:
     KStar (const options::Options &opts);
     void search() override;
+    /*
+      Session API: after search() found enough plans, continue_search()
+      finds the plans for a larger k or q, reusing the A* search space, the
+      path graph and the plans found so far. Only the new plans are passed
+      to the plan sinks. A larger q can only be handled if A* has not pruned
+      successors because of the old cost bound.
+    */
+    bool continue_search(int num_plans, double quality_bound) override;
 };
 }
 
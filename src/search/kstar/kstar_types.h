@@ -2,18 +2,71 @@
 #define KSTAR_KSTAR_TYPES_H
 
 #include <memory>
+#include <sstream>
+#include "../per_state_information.h"
 #include "../state_action_pair.h"
+#include "../state_registry.h"
+#include "arena.h"
+#include "persistent_heap.h"
 #include "unordered_set"
 
 using namespace std;
 
 namespace kstar {
-    typedef shared_ptr<StateActionPair> Sap;
-    typedef std::pair<Node, Node> Edge;
+    // Edges and path graph nodes are stored in arenas and referred to by
+    // their index.
+    typedef int SapID;
+    typedef int NodeID;
+    typedef Arena<StateActionPair> SapArena;
+    typedef Arena<Node> NodeArena;
+    // Persistent singly linked lists of sidetrack edges. A path graph node
+    // refers to the list of sidetracks of its plan (apart from its own edge),
+    // which shares all cells with the list of its parent.
+    struct SidetrackCell {
+        SapID sap;
+        int next;
+
+        SidetrackCell(SapID sap = -1, int next = -1) : sap(sap), next(next) {
+        }
+    };
+    typedef Arena<SidetrackCell> SidetrackArena;
     typedef std::vector<const GlobalOperator*> Plan;
     typedef std::vector<StateID> StateSequence;
     typedef std::stringstream Stream;
     typedef std::unordered_set<const GlobalOperator*> OperatorSet;
+    // H_in(v) holds the sidetrack edges into v, H_T(v) the roots of the
+    // incoming heaps along the tree path to v (as indices into the H_in arena).
+    typedef PersistentHeap<SapID> InHeap;
+    typedef PersistentHeap<int> TreeHeap;
+
+    // Incoming edges of a state are only collected while the state is open.
+    // When it is closed, they are sorted once and turned into H_in; edges
+    // found afterwards are inserted into the heap directly. The tree edge is
+    // kept aside in case the g value of the state changes later on.
+    struct IncomingHeapInfo {
+        std::vector<SapID> pending;
+        SapID tree_edge;
+        int root;
+        bool finalized;
+
+        IncomingHeapInfo()
+            : tree_edge(-1), root(InHeap::NO_NODE), finalized(false) {
+        }
+    };
+
+    // H_T(s) is H_T(parent(s)) with H_in(s) inserted. We remember what
+    // the heap was built from to reuse it as long as neither changed.
+    struct TreeHeapInfo {
+        int root;
+        int parent_root;
+        int in_root;
+        int version;
+
+        TreeHeapInfo()
+            : root(TreeHeap::NO_NODE), parent_root(TreeHeap::NO_NODE),
+              in_root(InHeap::NO_NODE), version(-1) {
+        }
+    };
 
     enum class Verbosity {
         SILENT,
@@ -0,0 +1,107 @@
+#ifndef KSTAR_PATH_GRAPH_QUEUE_H
+#define KSTAR_PATH_GRAPH_QUEUE_H
+
+#include "kstar_types.h"
+
+#include "../algorithms/priority_queues.h"
+
+#include <functional>
+#include <memory>
+#include <queue>
+#include <utility>
+#include <vector>
+
+/*
+  Priority queues for the Dijkstra search on the path graph. Entries are
+  (g, node) pairs. Ties between nodes with equal g are broken by their
+  index, which increases with the generation of nodes, so the order in
+  which nodes are expanded only depends on the order of the pushes.
+
+  Nodes are mostly pushed with increasing g, but when the search resumes
+  after A*, regenerated cross edges may lead to nodes below the g value
+  of the last expanded node. All queues support this.
+*/
+namespace kstar {
+enum class PathGraphQueueType {
+    BUCKET,
+    HEAP
+};
+
+class PathGraphQueue {
+public:
+    typedef std::pair<int, NodeID> Entry;
+
+    virtual ~PathGraphQueue() = default;
+    virtual void push(int g, NodeID node) = 0;
+    virtual Entry pop() = 0;
+    virtual Entry top() = 0;
+    virtual bool empty() const = 0;
+    virtual void clear() = 0;
+};
+
+// Binary heap; ties are broken in favour of the node generated first.
+class HeapPathGraphQueue : public PathGraphQueue {
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+public:
+    virtual void push(int g, NodeID node) override {
+        heap.push(std::make_pair(g, node));
+    }
+
+    virtual Entry pop() override {
+        Entry result = heap.top();
+        heap.pop();
+        return result;
+    }
+
+    virtual Entry top() override {
+        return heap.top();
+    }
+
+    virtual bool empty() const override {
+        return heap.empty();
+    }
+
+    virtual void clear() override {
+        heap = decltype(heap)();
+    }
+};
+
+/*
+  One bucket per g value, ties are broken in favour of the node generated
+  last. If the g values are spread too widely, the queue switches to a heap
+  (see priority_queues::AdaptiveQueue) that breaks ties arbitrarily, but
+  still deterministically.
+*/
+class BucketPathGraphQueue : public PathGraphQueue {
+    priority_queues::AdaptiveQueue<NodeID> queue;
+public:
+    virtual void push(int g, NodeID node) override {
+        queue.push(g, node);
+    }
+
+    virtual Entry pop() override {
+        return queue.pop();
+    }
+
+    virtual Entry top() override {
+        return queue.top();
+    }
+
+    virtual bool empty() const override {
+        return queue.empty();
+    }
+
+    virtual void clear() override {
+        queue.clear();
+    }
+};
+
+inline std::unique_ptr<PathGraphQueue> create_path_graph_queue(
+    PathGraphQueueType type) {
+    if (type == PathGraphQueueType::HEAP)
+        return std::unique_ptr<PathGraphQueue>(new HeapPathGraphQueue());
+    return std::unique_ptr<PathGraphQueue>(new BucketPathGraphQueue());
+}
+}
+
+#endif
@@ -0,0 +1,61 @@
+#include "pddl_strings.h"
+
+#include "../abstract_task.h"
+#include "../global_operator.h"
+#include "../global_state.h"
+
+using namespace std;
+
+namespace kstar {
+static string quote(const string &s) {
+    return "\"" + s + "\"";
+}
+
+static bool is_shown_in_states(const string &fact_name) {
+    return fact_name != "__special_value_false__" &&
+           fact_name != "__special_value_true__" &&
+           fact_name != "<none of those>" &&
+           fact_name.compare(0, 11, "NegatedAtom") != 0;
+}
+
+PddlStrings::PddlStrings(const AbstractTask &task,
+                         const vector<GlobalOperator> &operators) {
+    int num_vars = task.get_num_variables();
+    fact_names.resize(num_vars);
+    for (int var = 0; var < num_vars; ++var) {
+        int domain_size = task.get_variable_domain_size(var);
+        for (int value = 0; value < domain_size; ++value) {
+            string name = task.get_fact_name(FactPair(var, value));
+            fact_names[var].push_back(
+                is_shown_in_states(name) ? quote(name) : "");
+        }
+    }
+    for (const GlobalOperator &op : operators) {
+        int index = op.get_index();
+        if (index >= static_cast<int>(operator_names.size()))
+            operator_names.resize(index + 1);
+        operator_names[index] = quote(op.get_name());
+    }
+}
+
+const string &PddlStrings::get_operator_name(const GlobalOperator *op) const {
+    return operator_names[op->get_index()];
+}
+
+void PddlStrings::write_state(const GlobalState &state, bool single_line,
+                              ostream &os) const {
+    const char *newline = single_line ? "" : "\n";
+    os << "[" << newline;
+    bool first = true;
+    for (size_t var = 0; var < fact_names.size(); ++var) {
+        const string &name = fact_names[var][state[var]];
+        if (name.empty())
+            continue;
+        if (!first)
+            os << "," << newline;
+        first = false;
+        os << name;
+    }
+    os << newline << "]" << newline;
+}
+}
@@ -0,0 +1,39 @@
+#ifndef KSTAR_PDDL_STRINGS_H
+#define KSTAR_PDDL_STRINGS_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+class AbstractTask;
+class GlobalOperator;
+class GlobalState;
+
+/*
+  The strings needed to dump plans and states as JSON, built once for the
+  task. Fact and operator names are stored quoted and ready to be written,
+  so dumping a plan or a state needs no string operations per fact or
+  operator.
+*/
+namespace kstar {
+class PddlStrings {
+    // Quoted fact names, empty for facts that are not shown in states
+    // (negated atoms and values without an atom)
+    std::vector<std::vector<std::string>> fact_names;
+    // Quoted operator names, indexed by GlobalOperator::get_index()
+    std::vector<std::string> operator_names;
+public:
+    PddlStrings(const AbstractTask &task,
+                const std::vector<GlobalOperator> &operators);
+
+    const std::string &get_operator_name(const GlobalOperator *op) const;
+    /*
+      The atoms that hold in the state as a JSON array of fact names, with
+      one name per line unless single_line is set.
+    */
+    void write_state(const GlobalState &state, bool single_line,
+                     std::ostream &os) const;
+};
+}
+
+#endif
@@ -0,0 +1,137 @@
+#ifndef KSTAR_PERSISTENT_HEAP_H
+#define KSTAR_PERSISTENT_HEAP_H
+
+#include "../algorithms/segmented_vector.h"
+
+#include <cassert>
+#include <utility>
+#include <vector>
+
+/*
+  PersistentHeap is an arena of persistent (immutable) leftist heaps as used
+  by Eppstein's k shortest paths algorithm and K*.
+
+  A heap is identified by the index of its root node. Inserting into or
+  merging heaps never modifies existing nodes: only the nodes on the right
+  spines of the involved heaps are copied, all other nodes are shared with
+  the original heaps. Inserting into a heap of size n therefore allocates
+  O(log n) new nodes and leaves the original heap intact, so that e.g. the
+  tree heap of a state can share all of its structure with the tree heap of
+  its parent.
+
+  Every node stores the key it was inserted with. Keys must not change after
+  insertion, since this would break the heap property of every heap sharing
+  the node. Ties are broken in favour of the heap passed first to merge(),
+  i.e., elements inserted earlier stay closer to the root.
+*/
+namespace kstar {
+template<typename Value>
+class PersistentHeap {
+public:
+    static const int NO_NODE = -1;
+
+    struct HeapNode {
+        Value value;
+        int key;
+        int left;
+        int right;
+        // Length of the shortest path to an empty subtree (leftist rank).
+        int rank;
+
+        HeapNode(const Value &value, int key)
+            : value(value), key(key), left(NO_NODE), right(NO_NODE), rank(1) {
+        }
+    };
+
+private:
+    segmented_vector::SegmentedVector<HeapNode> nodes;
+
+    int get_rank(int node) const {
+        return node == NO_NODE ? 0 : nodes[node].rank;
+    }
+
+    int add_node(const HeapNode &node) {
+        nodes.push_back(node);
+        return nodes.size() - 1;
+    }
+
+public:
+    PersistentHeap() = default;
+
+    const HeapNode &operator[](int node) const {
+        assert(node != NO_NODE);
+        return nodes[node];
+    }
+
+    int merge(int heap1, int heap2) {
+        if (heap1 == NO_NODE)
+            return heap2;
+        if (heap2 == NO_NODE)
+            return heap1;
+        if (nodes[heap2].key < nodes[heap1].key)
+            std::swap(heap1, heap2);
+        HeapNode copy = nodes[heap1];
+        copy.right = merge(copy.right, heap2);
+        if (get_rank(copy.left) < get_rank(copy.right))
+            std::swap(copy.left, copy.right);
+        copy.rank = get_rank(copy.right) + 1;
+        return add_node(copy);
+    }
+
+    // Returns the root of a new heap; the heap rooted at root stays valid.
+    int insert(int root, const Value &value, int key) {
+        return merge(root, add_node(HeapNode(value, key)));
+    }
+
+    /*
+      Build a new heap from entries (value, key) sorted by key. The entries
+      are laid out as a complete binary tree, which is heap-ordered and
+      leftist, so no intermediate heaps are created.
+    */
+    int build_from_sorted(const std::vector<std::pair<Value, int>> &entries) {
+        int num_entries = entries.size();
+        if (num_entries == 0)
+            return NO_NODE;
+        int base = nodes.size();
+        for (int i = 0; i < num_entries; ++i) {
+            assert(i == 0 || entries[i - 1].second <= entries[i].second);
+            HeapNode node(entries[i].first, entries[i].second);
+            if (2 * i + 1 < num_entries)
+                node.left = base + 2 * i + 1;
+            if (2 * i + 2 < num_entries)
+                node.right = base + 2 * i + 2;
+            nodes.push_back(node);
+        }
+        for (int i = num_entries - 1; i >= 0; --i) {
+            HeapNode &node = nodes[base + i];
+            node.rank = get_rank(node.right) + 1;
+        }
+        return base;
+    }
+
+    // Largest key of the children of the node, or -1 if it has none.
+    int get_max_child_key(int node) const {
+        int max_key = -1;
+        for (int child : {nodes[node].left, nodes[node].right}) {
+            if (child != NO_NODE && nodes[child].key > max_key)
+                max_key = nodes[child].key;
+        }
+        return max_key;
+    }
+
+    // Append the nodes of the heap in preorder (root first).
+    void collect(int root, std::vector<int> &result) const {
+        if (root == NO_NODE)
+            return;
+        result.push_back(root);
+        collect(nodes[root].left, result);
+        collect(nodes[root].right, result);
+    }
+
+    size_t size() const {
+        return nodes.size();
+    }
+};
+}
+
+#endif
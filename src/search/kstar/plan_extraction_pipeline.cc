@@ -0,0 +1,104 @@
+#include "plan_extraction_pipeline.h"
+
+#include <cassert>
+
+using namespace std;
+
+namespace kstar {
+PlanExtractionPipeline::PlanExtractionPipeline(
+    const PlanReconstructor &plan_reconstructor, bool simple_plans_only,
+    int num_workers)
+    : plan_reconstructor(plan_reconstructor),
+      simple_plans_only(simple_plans_only),
+      // Enough work for all workers while the search commits plans
+      max_pending(16 * num_workers),
+      num_handed_back(0),
+      num_taken(0),
+      num_running(0),
+      shutting_down(false) {
+    assert(num_workers >= 1);
+    for (int i = 0; i < num_workers; ++i) {
+        workers.emplace_back(&PlanExtractionPipeline::work, this);
+    }
+}
+
+PlanExtractionPipeline::~PlanExtractionPipeline() {
+    {
+        lock_guard<mutex> lock(pipeline_mutex);
+        shutting_down = true;
+    }
+    work_available.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+void PlanExtractionPipeline::work() {
+    VisitedStates visited_states;
+    unique_lock<mutex> lock(pipeline_mutex);
+    while (true) {
+        work_available.wait(lock, [this]() {
+                                return shutting_down ||
+                                num_taken < num_handed_back +
+                                static_cast<int64_t>(jobs.size());
+                            });
+        if (shutting_down)
+            return;
+        Job *job = jobs[num_taken - num_handed_back].get();
+        ++num_taken;
+        ++num_running;
+        lock.unlock();
+        plan_reconstructor.extract_candidate(
+            job->candidate, simple_plans_only ? &visited_states : nullptr);
+        lock.lock();
+        job->done = true;
+        --num_running;
+        job_done.notify_all();
+    }
+}
+
+size_t PlanExtractionPipeline::get_num_pending() {
+    lock_guard<mutex> lock(pipeline_mutex);
+    return jobs.size();
+}
+
+void PlanExtractionPipeline::submit(PlanCandidate &&candidate) {
+    {
+        lock_guard<mutex> lock(pipeline_mutex);
+        jobs.emplace_back(new Job());
+        jobs.back()->candidate = move(candidate);
+    }
+    work_available.notify_one();
+}
+
+bool PlanExtractionPipeline::is_next_done() {
+    lock_guard<mutex> lock(pipeline_mutex);
+    return !jobs.empty() && jobs.front()->done;
+}
+
+PlanCandidate PlanExtractionPipeline::take_next() {
+    unique_lock<mutex> lock(pipeline_mutex);
+    assert(!jobs.empty());
+    job_done.wait(lock, [this]() {return jobs.front()->done; });
+    PlanCandidate candidate = move(jobs.front()->candidate);
+    jobs.pop_front();
+    ++num_handed_back;
+    return candidate;
+}
+
+void PlanExtractionPipeline::wait_until_idle() {
+    unique_lock<mutex> lock(pipeline_mutex);
+    job_done.wait(lock, [this]() {
+                      return num_running == 0 &&
+                      num_taken == num_handed_back +
+                      static_cast<int64_t>(jobs.size());
+                  });
+}
+
+void PlanExtractionPipeline::clear() {
+    wait_until_idle();
+    lock_guard<mutex> lock(pipeline_mutex);
+    num_handed_back += jobs.size();
+    jobs.clear();
+}
+}
@@ -0,0 +1,77 @@
+#ifndef KSTAR_PLAN_EXTRACTION_PIPELINE_H
+#define KSTAR_PLAN_EXTRACTION_PIPELINE_H
+
+#include "plan_reconstructor.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/*
+  Extracts the plans of path graph nodes in worker threads while the
+  Dijkstra search goes on.
+
+  The search prepares a candidate for every node it pops and submits it.
+  The workers extract the plans in any order, but the candidates are handed
+  back in the order in which they were submitted. The search commits them
+  in that order, so the same plans are accepted and written in the same
+  order as with serial extraction.
+
+  Workers only read the search space and the state registry. While
+  candidates are pending, the search must not register states or add
+  states to the search space.
+*/
+namespace kstar {
+class PlanExtractionPipeline {
+    struct Job {
+        PlanCandidate candidate;
+        bool done = false;
+    };
+
+    const PlanReconstructor &plan_reconstructor;
+    bool simple_plans_only;
+    size_t max_pending;
+    std::vector<std::thread> workers;
+    std::mutex pipeline_mutex;
+    std::condition_variable work_available;
+    std::condition_variable job_done;
+    // Submitted jobs that have not been handed back, in submission order.
+    // All counters are guarded by pipeline_mutex.
+    std::deque<std::unique_ptr<Job>> jobs;
+    // Number of jobs handed back and number of jobs taken by workers, both
+    // counted since the pipeline was created
+    int64_t num_handed_back;
+    int64_t num_taken;
+    int num_running;
+    bool shutting_down;
+
+    void work();
+public:
+    PlanExtractionPipeline(const PlanReconstructor &plan_reconstructor,
+                           bool simple_plans_only, int num_workers);
+    ~PlanExtractionPipeline();
+    PlanExtractionPipeline(const PlanExtractionPipeline &) = delete;
+    PlanExtractionPipeline &operator=(const PlanExtractionPipeline &) = delete;
+
+    // Number of pending candidates the search should not exceed
+    size_t get_max_pending() const {
+        return max_pending;
+    }
+    size_t get_num_pending();
+    void submit(PlanCandidate &&candidate);
+    // Whether the candidate submitted first has been extracted already
+    bool is_next_done();
+    // Waits until the candidate submitted first is extracted and returns it
+    PlanCandidate take_next();
+    // Waits until the workers have extracted all pending candidates
+    void wait_until_idle();
+    // Discards all pending candidates
+    void clear();
+};
+}
+
+#endif
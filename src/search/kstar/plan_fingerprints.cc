@@ -0,0 +1,132 @@
+#include "plan_fingerprints.h"
+
+#include "../global_operator.h"
+
+#include <algorithm>
+#include <cassert>
+#include <random>
+
+using namespace std;
+
+namespace kstar {
+// Fixed seed, so that runs are reproducible.
+static const uint64_t OPERATOR_KEYS_SEED = 2017;
+static const int MIN_TABLE_SIZE = 1024;
+
+PlanFingerprintSet::PlanFingerprintSet(int num_operators, bool verify)
+    : operator_keys(num_operators),
+      table(MIN_TABLE_SIZE),
+      num_entries(0),
+      verify(verify),
+      plan_offsets(1, 0) {
+    mt19937_64 rng(OPERATOR_KEYS_SEED);
+    for (PlanFingerprint &key : operator_keys) {
+        key.low = rng();
+        key.high = rng();
+    }
+}
+
+const PlanFingerprint &PlanFingerprintSet::get_key(
+    const GlobalOperator *op) const {
+    return operator_keys[op->get_index()];
+}
+
+PlanFingerprint PlanFingerprintSet::compute_fingerprint(const Plan &plan) const {
+    PlanFingerprint fingerprint;
+    for (const GlobalOperator *op : plan) {
+        fingerprint.add(get_key(op));
+    }
+    return fingerprint;
+}
+
+bool PlanFingerprintSet::is_same_plan(int stored_plan,
+                                      const vector<int> &sorted_plan) const {
+    size_t begin = plan_offsets[stored_plan];
+    size_t end = plan_offsets[stored_plan + 1];
+    return end - begin == sorted_plan.size() &&
+           equal(sorted_plan.begin(), sorted_plan.end(),
+                 sorted_plans.begin() + begin);
+}
+
+void PlanFingerprintSet::insert_entry(const Entry &entry) {
+    size_t mask = table.size() - 1;
+    size_t pos = entry.fingerprint.low & mask;
+    while (table[pos].plan != EMPTY) {
+        pos = (pos + 1) & mask;
+    }
+    table[pos] = entry;
+    ++num_entries;
+}
+
+void PlanFingerprintSet::grow() {
+    vector<Entry> old_table(table.size() * 2);
+    old_table.swap(table);
+    num_entries = 0;
+    for (const Entry &entry : old_table) {
+        if (entry.plan != EMPTY)
+            insert_entry(entry);
+    }
+}
+
+bool PlanFingerprintSet::contains(const PlanFingerprint &fingerprint) const {
+    size_t mask = table.size() - 1;
+    for (size_t pos = fingerprint.low & mask; table[pos].plan != EMPTY;
+         pos = (pos + 1) & mask) {
+        if (table[pos].fingerprint == fingerprint)
+            return true;
+    }
+    return false;
+}
+
+bool PlanFingerprintSet::insert(const PlanFingerprint &fingerprint,
+                                const Plan &plan) {
+    assert(fingerprint == compute_fingerprint(plan));
+    Entry entry;
+    entry.fingerprint = fingerprint;
+    entry.plan = NO_PLAN;
+
+    vector<int> sorted_plan;
+    if (verify) {
+        sorted_plan.reserve(plan.size());
+        for (const GlobalOperator *op : plan) {
+            sorted_plan.push_back(op->get_index());
+        }
+        sort(sorted_plan.begin(), sorted_plan.end());
+    }
+
+    size_t mask = table.size() - 1;
+    for (size_t pos = entry.fingerprint.low & mask; table[pos].plan != EMPTY;
+         pos = (pos + 1) & mask) {
+        if (table[pos].fingerprint == entry.fingerprint &&
+            (!verify || is_same_plan(table[pos].plan, sorted_plan))) {
+            return false;
+        }
+    }
+
+    if (verify) {
+        entry.plan = plan_offsets.size() - 1;
+        sorted_plans.insert(sorted_plans.end(),
+                            sorted_plan.begin(), sorted_plan.end());
+        plan_offsets.push_back(sorted_plans.size());
+    }
+    // Keep the load factor at most 1/2.
+    if (2 * (num_entries + 1) > static_cast<int>(table.size()))
+        grow();
+    insert_entry(entry);
+    return true;
+}
+
+void PlanFingerprintSet::clear() {
+    vector<Entry>(MIN_TABLE_SIZE).swap(table);
+    num_entries = 0;
+    vector<int>().swap(sorted_plans);
+    vector<size_t>(1, 0).swap(plan_offsets);
+}
+
+size_t PlanFingerprintSet::get_memory_usage() const {
+    return table.capacity() * sizeof(Entry) +
+           operator_keys.capacity() * sizeof(PlanFingerprint) +
+           sorted_plans.capacity() * sizeof(int) +
+           plan_offsets.capacity() * sizeof(size_t);
+}
+}
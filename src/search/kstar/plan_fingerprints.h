@@ -0,0 +1,98 @@
+#ifndef KSTAR_PLAN_FINGERPRINTS_H
+#define KSTAR_PLAN_FINGERPRINTS_H
+
+#include "kstar_types.h"
+
+#include <cstdint>
+#include <vector>
+
+/*
+  PlanFingerprintSet detects plans that are reorderings of each other, i.e.,
+  plans with the same multiset of operators.
+
+  Every operator gets a random 128-bit key, and the fingerprint of a plan is
+  the sum of the keys of its operators (modulo 2^128). The fingerprint does
+  not depend on the order of the operators, and it is computed in linear
+  time without copying or sorting the plan. Fingerprints are stored in a
+  flat hash table with open addressing (linear probing).
+
+  Different multisets of operators have the same fingerprint with
+  negligible probability. If this is not good enough, exact verification
+  additionally stores the sorted operator indices of every plan and
+  compares them whenever two fingerprints are equal.
+*/
+namespace kstar {
+struct PlanFingerprint {
+    uint64_t low;
+    uint64_t high;
+
+    PlanFingerprint() : low(0), high(0) {
+    }
+
+    void add(const PlanFingerprint &other) {
+        low += other.low;
+        high += other.high + (low < other.low ? 1 : 0);
+    }
+
+    void subtract(const PlanFingerprint &other) {
+        uint64_t old_low = low;
+        low -= other.low;
+        high -= other.high + (old_low < other.low ? 1 : 0);
+    }
+
+    bool operator==(const PlanFingerprint &other) const {
+        return low == other.low && high == other.high;
+    }
+};
+
+class PlanFingerprintSet {
+    static const int EMPTY = -2;
+    static const int NO_PLAN = -1;
+
+    struct Entry {
+        PlanFingerprint fingerprint;
+        // Index into plan_offsets (exact verification only) or NO_PLAN.
+        // EMPTY marks unused slots.
+        int plan;
+
+        Entry() : plan(EMPTY) {
+        }
+    };
+
+    std::vector<PlanFingerprint> operator_keys;
+    std::vector<Entry> table;
+    int num_entries;
+    bool verify;
+    // Sorted operator indices of all plans, concatenated (exact
+    // verification only). Plan i is stored at plan_offsets[i] and ends
+    // at plan_offsets[i + 1].
+    std::vector<int> sorted_plans;
+    std::vector<size_t> plan_offsets;
+
+    bool is_same_plan(int stored_plan, const std::vector<int> &sorted_plan) const;
+    void insert_entry(const Entry &entry);
+    void grow();
+
+public:
+    PlanFingerprintSet(int num_operators, bool verify);
+
+    const PlanFingerprint &get_key(const GlobalOperator *op) const;
+    PlanFingerprint compute_fingerprint(const Plan &plan) const;
+    bool is_verifying() const {
+        return verify;
+    }
+
+    // Whether the set contains a plan with the given fingerprint.
+    bool contains(const PlanFingerprint &fingerprint) const;
+    /*
+      Returns true if no reordering of the plan was in the set before. The
+      fingerprint has to be the one of the plan; the plan itself is only
+      used for exact verification.
+    */
+    bool insert(const PlanFingerprint &fingerprint, const Plan &plan);
+    void clear();
+    size_t get_memory_usage() const;
+};
+}
+
+#endif
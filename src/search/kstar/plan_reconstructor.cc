@@ -8,34 +8,43 @@
 #include <sstream>
 #include "../successor_generator.h"
 #include "../globals.h"
+#include "../utils/util.h"
 
 namespace kstar {
 
-PlanReconstructor::PlanReconstructor(std::unordered_map<Node, Node>& parent_sap,
-                                      std::unordered_set<Edge>& cross_edge,
+PlanReconstructor::PlanReconstructor(const NodeArena &pg_nodes,
+                                      const SidetrackArena &sidetrack_lists,
+                                      const SapArena &saps,
                                       StateID goal_state,
                                       StateRegistry* state_registry,
                                       SearchSpace* search_space,
                                       bool skip_reorderings,     
+                                      bool verify_reorderings,
                                       bool dump_plans,
-                                      Verbosity verbosity) :
-                                              parent_node(parent_sap),
-                                              cross_edge(cross_edge),
+                                      Verbosity verbosity,
+                                      SearchStatistics &statistics) :
+                                              pg_nodes(pg_nodes),
+                                              sidetrack_lists(sidetrack_lists),
+                                              saps(saps),
                                               goal_state(goal_state),
                                               state_registry(state_registry),
                                               search_space(search_space),
                                               skip_reorderings(skip_reorderings), 
                                               dump_plans(dump_plans),
                                               verbosity(verbosity), 
+                                              statistics(statistics),
+                                              accepted_plans(g_operators.size(),
+                                                             verify_reorderings),
                                               attempted_plans(0), 
                                               last_plan_cost(-1), 
                                               number_of_kept_plans(0) {
 }
 
 void PlanReconstructor::clear() {
+    processed_seqs.clear();
+    accepted_sequences.clear();
     attempted_plans = 0;
     number_of_kept_plans = 0;
-    kept_plans.clear();
     accepted_plans.clear();
 }
 
@@ -43,48 +52,118 @@ void PlanReconstructor::set_goal_state(StateID goal_state) {
     this->goal_state = goal_state;
 }
 
-std::vector<Node> PlanReconstructor::djkstra_traceback(Node node)    {
-    vector<Node> path;
-    Node current_sap = node;
-    for(;;) {
-        path.push_back(current_sap);
-        if(!current_sap.sap->op) {
-            break;
-        }
-        current_sap = parent_node.at(current_sap);
+// The sequence starts with the sidetrack closest to the goal and ends with
+// the edge of the node itself.
+vector<SapID> PlanReconstructor::get_sidetrack_seq(NodeID node) const {
+    vector<SapID> seq;
+    const Node &pg_node = pg_nodes[node];
+    if (pg_node.sap == -1)
+        return seq;
+    for (int cell = pg_node.sidetracks; cell != -1;
+         cell = sidetrack_lists[cell].next) {
+        seq.push_back(sidetrack_lists[cell].sap);
     }
-    reverse(path.begin(), path.end());
-    return path;
+    reverse(seq.begin(), seq.end());
+    seq.push_back(pg_node.sap);
+    return seq;
 }
 
-vector<Node> PlanReconstructor::compute_sidetrack_seq(vector<Node>& path) {
-    vector<Node> seq;
-    int last_index = path.size() - 1;
-    Node last_element = path[last_index];
-    seq.push_back(last_element);
-
-    for (size_t i = last_index; i >= 2; --i) {
-       Edge e(path[i-1], path[i]);
-
-        if(cross_edge.find(e) != cross_edge.end()) {
-            seq.push_back(path[i - 1]);
+PlanFingerprint PlanReconstructor::get_tree_fingerprint(StateID state_id) {
+    int tree_version = search_space->tree_version;
+    // States on the tree path without an up-to-date fingerprint, bottom up
+    vector<GlobalState> path;
+    GlobalState state = state_registry->lookup_state(state_id);
+    while (tree_fingerprints[state].tree_version != tree_version) {
+        path.push_back(state);
+        const SearchNodeInfo &info = search_space->search_node_infos[state];
+        if (info.creating_operator == -1)
+            break;
+        state = state_registry->lookup_state(info.parent_state_id);
+    }
+    for (auto it = path.rbegin(); it != path.rend(); ++it) {
+        const SearchNodeInfo &info = search_space->search_node_infos[*it];
+        PlanFingerprint fingerprint;
+        if (info.creating_operator != -1) {
+            GlobalState parent = state_registry->lookup_state(info.parent_state_id);
+            fingerprint = tree_fingerprints[parent].fingerprint;
+            fingerprint.add(accepted_plans.get_key(
+                                &g_operators[info.creating_operator]));
         }
+        TreeFingerprint &entry = tree_fingerprints[*it];
+        entry.fingerprint = fingerprint;
+        entry.tree_version = tree_version;
     }
-    reverse(seq.begin(), seq.end());
-    return seq;
+    return tree_fingerprints[state_registry->lookup_state(state_id)].fingerprint;
+}
 
+/*
+  The plan of a sidetrack sequence consists of tree paths and sidetracks:
+  going backwards from the goal, it follows the tree up to the target v of
+  the next sidetrack (u,v) and continues at u. The operators on the tree
+  path from v down to u are those on the tree path to u minus those on the
+  tree path to v, so the fingerprint of the plan is
+    T(goal) + sum over all sidetracks (u,v) of (key(op) + T(u) - T(v)),
+  without the last operator (the goal operator, removed from all plans).
+*/
+PlanFingerprint PlanReconstructor::get_plan_fingerprint(const vector<SapID> &seq) {
+    PlanFingerprint fingerprint = get_tree_fingerprint(goal_state);
+    for (SapID sap_id : seq) {
+        const StateActionPair &sap = saps[sap_id];
+        fingerprint.add(accepted_plans.get_key(sap.get_op()));
+        fingerprint.add(get_tree_fingerprint(sap.from));
+        fingerprint.subtract(get_tree_fingerprint(sap.to));
+    }
+    const GlobalOperator *last_op;
+    if (!seq.empty() && saps[seq[0]].to == goal_state) {
+        last_op = saps[seq[0]].get_op();
+    } else {
+        GlobalState goal = state_registry->lookup_state(goal_state);
+        last_op = &g_operators[
+            search_space->search_node_infos[goal].creating_operator];
+    }
+    fingerprint.subtract(accepted_plans.get_key(last_op));
+    return fingerprint;
 }
 
-void PlanReconstructor::extract_plan(vector<Node> &seq,
-                                    Plan &plan,
-                                    StateSequence &state_seq) {
+/*
+  Between two sidetracks, the plan follows a tree path. These segments of
+  the plan have to be disjoint for the plan to be simple. This cannot be
+  decided without extracting the plan, but if a state is the first or last
+  state of two segments, the plan is certainly not simple.
+*/
+bool PlanReconstructor::has_repeated_endpoints(const vector<SapID> &seq) const {
+    vector<int> endpoints;
+    StateID bottom = goal_state;
+    for (size_t i = 0; i <= seq.size(); ++i) {
+        StateID top = i < seq.size() ? saps[seq[i]].to
+                      : state_registry->get_initial_state().get_id();
+        endpoints.push_back(bottom.hash());
+        if (top != bottom)
+            endpoints.push_back(top.hash());
+        if (i < seq.size())
+            bottom = saps[seq[i]].from;
+    }
+    sort(endpoints.begin(), endpoints.end());
+    return adjacent_find(endpoints.begin(), endpoints.end()) != endpoints.end();
+}
 
+bool PlanReconstructor::extract_plan(const vector<SapID> &seq,
+                                     Plan &plan,
+                                     StateSequence &state_seq,
+                                     VisitedStates *visited) const {
+    // Only read the search node infos, other threads may do the same
+    const PerStateInformation<SearchNodeInfo> &search_node_infos =
+        search_space->search_node_infos;
+    if (visited)
+        visited->reset();
     GlobalState current_state = state_registry->lookup_state(goal_state);
     state_seq.push_back(current_state.get_id());
+    if (visited)
+        visited->visit(current_state.get_id());
     int seq_index = 0;
     int seq_size = seq.size();
     for(;;) {
-        const SearchNodeInfo &info = search_space->search_node_infos[current_state];
+        const SearchNodeInfo &info = search_node_infos[current_state];
         // Initial state reached and all edges of seq consumed
         if (info.creating_operator == -1 && seq_index == seq_size) {
             assert(info.parent_state_id == StateID::no_state);
@@ -92,10 +171,11 @@ void PlanReconstructor::extract_plan(vector<Node> &seq,
         }
 
         // second last edge in seq and attachable to what we already have
-        if(seq_index <= seq_size - 1 && seq[seq_index].sap->to == current_state.get_id()) {
+        if(seq_index <= seq_size - 1 && saps[seq[seq_index]].to == current_state.get_id()) {
             // prepend edge from seq
-            plan.push_back(seq[seq_index].sap->op);
-            current_state = state_registry->lookup_state(seq[seq_index].sap->from);
+            const StateActionPair &sap = saps[seq[seq_index]];
+            plan.push_back(sap.get_op());
+            current_state = state_registry->lookup_state(sap.from);
             ++seq_index;
         }
         else {
@@ -105,120 +185,165 @@ void PlanReconstructor::extract_plan(vector<Node> &seq,
             current_state = state_registry->lookup_state(info.parent_state_id);
         }
         state_seq.push_back(current_state.get_id());
-        if (verbosity >= Verbosity::NORMAL) {
-            // Check that the last op on plan leads from the last state in state_seq to the one before it
-            StateID parentID = state_seq[state_seq.size()-1]; 
-            StateID childID = state_seq[state_seq.size()-2]; 
-            const GlobalOperator* curr_op = plan[plan.size() - 1];
-            GlobalState parent = state_registry->lookup_state(parentID);
-            GlobalState next = state_registry->get_successor_state(parent, *curr_op);
-            if (next.get_id() != childID) {
-                cout << "----------------------" << endl;
-                cout << "State in sequence" << endl;
-                GlobalState child = state_registry->lookup_state(childID);
-                child.dump_fdr();
-                cout << "Real successor" << endl;
-                next.dump_fdr();
-                cout << "----------------------" << endl;
-            }
-        }
-
+        if (visited && !visited->visit(current_state.get_id()))
+            return false;
     }
     reverse(plan.begin(), plan.end());
     reverse(state_seq.begin(), state_seq.end());
+    return true;
 }
 
-bool PlanReconstructor::is_simple_plan(StateSequence seq, StateRegistry* state_registry) {
-    PerStateInformation<bool> seen;
-    for (size_t i = 0; i < seq.size(); ++i) {
-        GlobalState s = state_registry->lookup_state(seq[i]);
-        if (!seen[s]) {
-           seen[s] = true;
-        }
-        else {
-           return false;
+// Check that every operator of the plan leads from its state in state_seq
+// to the next one. This registers states, so it is only done when plans
+// are extracted in the search thread.
+void PlanReconstructor::check_state_sequence(const Plan &plan,
+                                             const StateSequence &state_seq) {
+    for (size_t i = 0; i < plan.size(); ++i) {
+        GlobalState parent = state_registry->lookup_state(state_seq[i]);
+        GlobalState next = state_registry->get_successor_state(parent, *plan[i]);
+        if (next.get_id() != state_seq[i + 1]) {
+            cout << "----------------------" << endl;
+            cout << "State in sequence" << endl;
+            GlobalState child = state_registry->lookup_state(state_seq[i + 1]);
+            child.dump_fdr();
+            cout << "Real successor" << endl;
+            next.dump_fdr();
+            cout << "----------------------" << endl;
         }
     }
-    return true;
 }
 
-bool PlanReconstructor::add_plan(Node node, bool simple_plans_only) {
+bool PlanReconstructor::add_plan(NodeID node, bool simple_plans_only) {
     // Returns a boolean whether the plan was added
+    SearchPhaseTimer phase_timer(statistics, SearchPhase::PLAN_EXTRACTION);
+    PlanCandidate candidate;
+    if (!prepare_candidate(node, simple_plans_only, candidate))
+        return false;
+    extract_candidate(candidate,
+                      simple_plans_only ? &visited_states : nullptr);
+    if (candidate.extracted && verbosity >= Verbosity::NORMAL)
+        check_state_sequence(candidate.plan, candidate.states);
+    return commit_candidate(candidate);
+}
+
+bool PlanReconstructor::prepare_candidate(NodeID node, bool simple_plans_only,
+                                          PlanCandidate &candidate) {
+    candidate.node = node;
+    candidate.seq = get_sidetrack_seq(node);
+    const vector<SapID> &seq = candidate.seq;
+    // A regenerated node may represent a sequence that was already processed
+    // before the path graph was updated.
+    statistics.start_phase(SearchPhase::DEDUPLICATION);
+    bool is_new_seq = processed_seqs.insert(seq);
+    statistics.end_phase();
+    if (pg_nodes[node].regenerated && !is_new_seq) {
+        statistics.inc_avoided_reextractions();
+        return false;
+    }
+
     attempted_plans++;
     if (attempted_plans % 10000 == 0) {
         printf ("Attempted plans: %4.2fM\n", attempted_plans / 1000000.0);
     }
-    vector<Node> path = djkstra_traceback(node);
-    vector<Node> seq;
 
-    if (path.size() > 1) {
-         seq = compute_sidetrack_seq(path);
+    // Reject plans before extracting them whenever possible
+    if (simple_plans_only && has_repeated_endpoints(seq)) {
+        statistics.inc_rejected_before_extraction();
+        statistics.inc_rejected_non_simple();
+        return false;
+    }
+    if (skip_reorderings) {
+        SearchPhaseTimer dedup_timer(statistics, SearchPhase::DEDUPLICATION);
+        candidate.fingerprint = get_plan_fingerprint(seq);
+        if (!accepted_plans.is_verifying() &&
+            accepted_plans.contains(candidate.fingerprint)) {
+            statistics.inc_rejected_before_extraction();
+            return false;
+        }
     }
+    return true;
+}
 
-    Plan plan;
-    StateSequence state_seq;
-    extract_plan(seq, plan, state_seq);
+void PlanReconstructor::extract_candidate(PlanCandidate &candidate,
+                                          VisitedStates *visited) const {
+    candidate.extracted = extract_plan(candidate.seq, candidate.plan,
+                                       candidate.states, visited);
+}
+
+bool PlanReconstructor::commit_candidate(PlanCandidate &candidate) {
+    if (!candidate.extracted) {
+        statistics.inc_rejected_non_simple();
+        return false;
+    }
+    Plan &plan = candidate.plan;
     plan.shrink_to_fit();
+    // Drop the goal operator and the state it leads to
     plan.pop_back();
+    candidate.states.pop_back();
 
-    if (!simple_plans_only || is_simple_plan(state_seq, state_registry)) {
-        if (!is_duplicate(plan)) {
-            last_plan_cost = calculate_plan_cost(plan);
-            return keep_plan(plan, last_plan_cost);
-        }
+    if (!is_duplicate(candidate.fingerprint, plan)) {
+        last_plan_cost = calculate_plan_cost(plan);
+        return keep_plan(plan, candidate.states, last_plan_cost);
     }
     return false;
 }
 
-void PlanReconstructor::add_plan_explicit_no_check(Plan plan) {
-    plan.shrink_to_fit();
+void PlanReconstructor::add_plan_explicit_no_check() {
+    Plan plan;
+    StateSequence states;
+    extract_plan(vector<SapID>(), plan, states, nullptr);
     plan.pop_back();
+    states.pop_back();
     last_plan_cost = calculate_plan_cost(plan);
-    keep_plan(plan, last_plan_cost);
+    keep_plan(plan, states, last_plan_cost);
 }
 
-bool PlanReconstructor::keep_plan(const Plan& plan, int cost) {
-    auto it = kept_plans.find(cost);
-    if (it == kept_plans.end()) {
-        PlansSet plans_for_cost;
-        plans_for_cost.insert(plan);
-        kept_plans.insert({cost, plans_for_cost});
-        number_of_kept_plans++;
-        if (dump_plans) {
-            output_plan(plan, cost);
-            dump_dot_plan(plan);
-        }
-        save_plan(plan, true);
-        return true;
-    } 
-    auto p = it->second.insert(plan);
-    if (p.second) {
-        number_of_kept_plans++;
-        if (dump_plans) {
-            output_plan(plan, cost);
-            dump_dot_plan(plan);
-        }
-        save_plan(plan, true);        
+// Duplicates are detected by is_duplicate, so the plan is new and can be
+// passed on right away.
+bool PlanReconstructor::keep_plan(const Plan& plan,
+                                  const StateSequence &states, int cost) {
+    number_of_kept_plans++;
+    SearchPhaseTimer phase_timer(statistics, SearchPhase::PLAN_OUTPUT);
+    if (dump_plans) {
+        output_plan(plan, cost);
+        dump_dot_plan(plan);
+    }
+    for (auto &sink : plan_sinks) {
+        sink->add_plan(plan, states, cost);
     }
-    return p.second;
+    return true;
 }
 
+void PlanReconstructor::add_plan_sink(unique_ptr<PlanSink> sink) {
+    plan_sinks.push_back(move(sink));
+}
+
+void PlanReconstructor::finish_plan_sinks() {
+    SearchPhaseTimer phase_timer(statistics, SearchPhase::PLAN_OUTPUT);
+    for (auto &sink : plan_sinks) {
+        sink->finish();
+    }
+}
 
 int PlanReconstructor::get_last_added_plan_cost() const {
     return last_plan_cost;
 }
 
-bool PlanReconstructor::is_duplicate(const Plan& plan) {
-    if (!skip_reorderings)
-        return false;
-    
-    // Checks whether the plan is a duplicate of an existing plan, and if not, add it to existing plans
+bool PlanReconstructor::is_duplicate(const PlanFingerprint &fingerprint,
+                                     const Plan& plan) {
+    SearchPhaseTimer phase_timer(statistics, SearchPhase::DEDUPLICATION);
+    if (!skip_reorderings) {
+        vector<int> op_indices;
+        op_indices.reserve(plan.size());
+        for (const GlobalOperator *op : plan)
+            op_indices.push_back(op->get_index());
+        return !accepted_sequences.insert(op_indices);
+    }
 
-    // Each plan is kept as a sorted vector by operator ids
-    Plan unordered_plan = plan;
-    std::sort(unordered_plan.begin(), unordered_plan.end());
-	std::pair<PlansSet::iterator, bool > result = accepted_plans.insert(unordered_plan);
-    return !result.second;
+    // Checks whether the plan is a duplicate of an existing plan, and if not, add it to existing plans
+    bool is_new = accepted_plans.insert(fingerprint, plan);
+    statistics.set_reordering_check_memory(accepted_plans.get_memory_usage());
+    return !is_new;
 }
 
 void PlanReconstructor::dump_dot_plan(const Plan& plan) {
@@ -271,136 +396,6 @@ void PlanReconstructor::dump_dot_plan(const Plan& plan) {
     file.close();
 }
 
-void PlanReconstructor::dump_state_with_actions(const StateID& stateID, const OperatorSet& actions, std::ostream& os) {
-
-    os << "{ ";
-    os << "\"state\" : ";
-    dump_state_json(stateID, os);
-    os << ", ";
-    os << "\"actions_from_plans\" : " ;
-    os << "[";
-    bool first = true;
-    for (auto op : actions) {
-        if (!first) {
-            os << "," << endl;
-        }
-        first = false;
-        dump_action_json(op, os);
-
-    }
-    os << "]";
-    os << ",";
-
-    GlobalState current_state = state_registry->lookup_state(stateID);
-    vector<const GlobalOperator *> applicable_ops;
-    g_successor_generator->generate_applicable_ops(current_state, applicable_ops);
-
-    vector<const GlobalOperator *> other_applicable_ops;
-    for (auto op : applicable_ops) {
-        if (actions.find(op) != actions.end())
-            other_applicable_ops.push_back(op);
-    }
-
-    os << "\"other_applicable_actions\" : " ;
-    os << "[";
-    first = true;
-    for (auto op : other_applicable_ops) {
-        if (!first) {
-            os << "," << endl;
-        }
-        first = false;
-        dump_action_json(op, os);
-    }
-    os << "]";
-    os << "}";
-}
-
-void PlanReconstructor::action_name_parsing(std::string op_name, std::vector<std::string>& parsed) {
-    std::string s = op_name.substr(1, op_name.length() - 2); // without the first and last
-    size_t pos = 0;
-    while ((pos = s.find(" ")) != std::string::npos) {
-        parsed.push_back(s.substr(0, pos));
-        s.erase(0, pos + 1);
-    }
-    parsed.push_back(s);
-}
-
-
-void PlanReconstructor::dump_action_json(const GlobalOperator *op, std::ostream& os) {
-/*
-{"params": ["ca", "d2", "c", "n1", "c0", "n0"], "name": "sendtohome"}
-*/
-    std::vector<std::string> parsed;
-    action_name_parsing(op->get_name(), parsed);
-
-    os << "{ \"name\" : " << "\"" << parsed[0] << "\"" ;
-    os << ", ";
-    os << "\"params\" : [";
-    bool first = true;
-    for (size_t i = 1; i< parsed.size(); ++i) {
-        if (!first) {
-            os << ", ";
-        }
-        first = false;
-        os << "\"" << parsed[i] << "\"";
-    }
-    os << "]}";
-}
-
-std::string PlanReconstructor::fact_to_pddl(std::string fact) const {
-    /*  "Atom bottomcol(ha)" -> "(bottomcol ha)""
-        "NegatedAtom clear(da)" -> "(not (clear da))"
-    */
-    // Check if starts with "Atom"
-    if (fact.substr(0,4) == "Atom") {
-        return restructure_fact(fact.substr(5, fact.length()-5));
-    }   
-    if (fact.substr(0,11) == "NegatedAtom") {
-        return "(not " + restructure_fact(fact.substr(12, fact.length()-12)) + ")";
-    }   
-    cerr << "SHOULD NOT HAPPEN!!! Got fact not starting with Atom or NegatedAtom: " << fact << endl;
-    return fact;
-}
-
-std::string PlanReconstructor::restructure_fact(std::string fact) const {
-    /*  "bottomcol(ha)" -> "(bottomcol ha)""
-        "at(da db)" -> "(at da db)"
-    */
-    size_t pos = fact.find("(");
-    std::string name = fact.substr(0, pos);
-    return "(" + name + " " + fact.substr(pos+1, fact.length() - pos - 1);
-}
-
-
-void PlanReconstructor::dump_state_json(const StateID& state, std::ostream& os) {
-/*
-["(value c0 n0)", "(value ca n1)", "(value c2 n2)", "(value c3 n3)", "(value c4 n4)"]
-*/
-    GlobalState current_state = state_registry->lookup_state(state);
-    State s(state_registry->get_task(), current_state.get_values());
-    std::vector<std::string> state_parsed;
-
-    for (FactProxy fact : s) {
-        string fact_name = fact.get_name();
-        if (fact_name != "<none of those>" && fact_name != "false" && fact_name != "true") {
-            state_parsed.push_back(fact_to_pddl(fact_name));
-        }
-    }
-
-    os << "[";
-    bool first = true;
-    for (size_t i = 0; i< state_parsed.size(); ++i) {
-        if (!first) {
-            os << ", ";
-        }
-        first = false;
-        os << "\"" << state_parsed[i] << "\"";
-    }
-    os << "]";
-}
-
-
-
 // Moved from TopKEagerSearch
 void PlanReconstructor::output_plan(const Plan& plan, int cost) {
     for (size_t j = 0; j < plan.size(); ++j) {
@@ -410,42 +405,4 @@ void PlanReconstructor::output_plan(const Plan& plan, int cost) {
     cout << "Plan cost: " << cost << endl;
 }
 
-void PlanReconstructor::dump_plans_json(std::ostream& os, bool dump_states) const {
-    os << "{ \"plans\" : [" << endl;
-    bool first_dumped = false;
-    for (auto& plans : kept_plans) {
-        for (auto& plan : plans.second) {    
-            if (first_dumped)
-                    os << "," << endl;
-                dump_plan_json(plan, os, dump_states);
-                first_dumped = true;
-        }
-    }
-    os << "]}" << endl;
-}
-
-void PlanReconstructor::dump_plan_json(Plan plan, std::ostream& os, bool dump_states) const {
-    int plan_cost = calculate_plan_cost(plan);
-    os << "{ ";
-    os << "\"cost\" : " << plan_cost << "," << endl; 
-    os << "\"actions\" : [" << endl;
-    if (plan.size() > 0) {
-        os << "\""  << plan[0]->get_name() << "\"";
-        for (size_t i = 1; i < plan.size(); ++i) {
-            os << ", \"" << plan[i]->get_name() << "\"";
-        }
-    }
-    os << "]";
-    if (dump_states) {
-        os << "," << endl;
-        os << "\"states\" : [" << endl;
-
-        vector<StateID> trace;
-        search_space->trace_from_plan(plan, trace);
-        search_space->dump_trace(trace, os);
-        os << "]";
-    }
-    os << "}" << endl;
-}
-
 }
@@ -2,34 +2,103 @@
 #define KSTAR_PLAN_RECONSTRUCTOR_H
 
 #include "kstar_types.h"
+#include "plan_fingerprints.h"
+#include "plan_sink.h"
+#include "sequence_set.h"
+
+#include "../search_space.h"
+#include "../search_statistics.h"
+
+#include <cstdint>
 
 namespace kstar {
 
+// A path graph node whose plan may still have to be extracted
+struct PlanCandidate {
+    NodeID node;
+    std::vector<SapID> seq;
+    PlanFingerprint fingerprint;
+    Plan plan;
+    // The states visited by the plan, passed on to the plan sinks
+    StateSequence states;
+    // False if the plan is not simple and only simple plans are wanted
+    bool extracted;
+
+    PlanCandidate() : node(-1), extracted(false) {
+    }
+};
+
+/*
+  The states visited by the plan extracted last. A state has been visited
+  if its entry equals the current generation, so increasing the
+  generation resets all states at once. Every thread that extracts plans
+  needs its own instance.
+*/
+class VisitedStates {
+    std::vector<int> visited_generation;
+    int current_generation;
+public:
+    VisitedStates() : current_generation(0) {
+    }
+
+    void reset() {
+        ++current_generation;
+    }
+
+    // Marks the state and returns false if it has been visited already
+    bool visit(StateID state) {
+        size_t index = state.hash();
+        if (index >= visited_generation.size())
+            visited_generation.resize(index + 1, -1);
+        if (visited_generation[index] == current_generation)
+            return false;
+        visited_generation[index] = current_generation;
+        return true;
+    }
+};
+
 class PlanReconstructor {
-    std::unordered_map<Node, Node> &parent_node;
-    std::unordered_set<Edge> &cross_edge;
+    const NodeArena &pg_nodes;
+    const SidetrackArena &sidetrack_lists;
+    const SapArena &saps;
     StateID goal_state;
     StateRegistry* state_registry;
     SearchSpace* search_space;
     const bool skip_reorderings;
     bool dump_plans;
     Verbosity verbosity;
-    typedef std::unordered_set<Plan> PlansSet;
+    SearchStatistics &statistics;
+
+    // Sidetrack sequences processed so far. Regenerated path graph nodes are
+    // checked against them to process every sequence once.
+    SequenceSet processed_seqs;
 
-    // Keep plans (sorted vectors of operators) in a set
-    PlansSet accepted_plans;
-    int attempted_plans;
+    // Operator multisets of the accepted plans (with skip_reorderings)
+    PlanFingerprintSet accepted_plans;
+    // Operator sequences of the accepted plans (without skip_reorderings).
+    // Once a state got a new parent, different sidetrack sequences can lead
+    // to the same plan.
+    SequenceSet accepted_sequences;
+    // Fingerprints of the operators on the tree path to a state. They
+    // are computed lazily and recomputed after any state got a new parent
+    // (see SearchSpace::tree_version), since this can change the tree.
+    struct TreeFingerprint {
+        PlanFingerprint fingerprint;
+        int tree_version = -1;
+    };
+    PerStateInformation<TreeFingerprint> tree_fingerprints;
+    VisitedStates visited_states;
+    int64_t attempted_plans;
     int last_plan_cost;
-    std::unordered_map<int, PlansSet> kept_plans; // Plans kept in a set by cost
     int number_of_kept_plans;
+    // Accepted plans are passed on to the sinks instead of being kept
+    std::vector<std::unique_ptr<PlanSink>> plan_sinks;
 
-    std::string fact_to_pddl(std::string fact) const;
-    std::string restructure_fact(std::string fact) const;
-    void dump_state_with_actions(const StateID& state, const OperatorSet& actions, std::ostream& os);
-    void dump_action_json(const GlobalOperator *op, std::ostream& os);
-    void dump_state_json(const StateID& state, std::ostream& os);
-    void action_name_parsing(std::string op_name, std::vector<std::string>& parsed);
-    bool is_duplicate(const Plan& plan);
+    PlanFingerprint get_tree_fingerprint(StateID state_id);
+    PlanFingerprint get_plan_fingerprint(const std::vector<SapID> &seq);
+    bool has_repeated_endpoints(const std::vector<SapID> &seq) const;
+    bool is_duplicate(const PlanFingerprint &fingerprint, const Plan& plan);
+    void check_state_sequence(const Plan &plan, const StateSequence &state_seq);
 
     size_t get_hash_value(const Plan &plan) const {
         std::size_t seed = plan.size();
@@ -39,33 +108,55 @@ class PlanReconstructor {
         return seed;
     }
 
-    bool keep_plan(const Plan& plan, int cost);
+    bool keep_plan(const Plan& plan, const StateSequence &states, int cost);
     void output_plan(const Plan& plan, int cost);
-    void dump_plan_json(Plan plan, std::ostream& os, bool dump_states) const;
 
 public:
-    PlanReconstructor(std::unordered_map<Node, Node>& parent_sap,
-                       std::unordered_set<Edge>& cross_edge,
+    PlanReconstructor(const NodeArena &pg_nodes,
+                       const SidetrackArena &sidetrack_lists,
+                       const SapArena &saps,
                        StateID goal_state,
                        StateRegistry* state_registry,
                        SearchSpace* search_space,
                        bool skip_reorderings,
+                       bool verify_reorderings,
                        bool dump_plans,
-                       Verbosity verbosity);
+                       Verbosity verbosity,
+                       SearchStatistics &statistics);
 
     virtual ~PlanReconstructor() = default;
-    std::vector<Node> djkstra_traceback(Node node);
-    std::vector<Node> compute_sidetrack_seq(std::vector<Node>& path);
-    void extract_plan(vector<Node>& seq, Plan &plan, StateSequence &state_seq);
-    bool is_simple_plan(StateSequence seq, StateRegistry* state_registry);
+    std::vector<SapID> get_sidetrack_seq(NodeID node) const;
+    /*
+      Extract the plan of the sidetrack sequence. If visited states are
+      given, extraction stops as soon as a state is visited a second time
+      and false is returned. Neither the reconstructor nor the search space
+      is changed, so several threads may extract plans at the same time.
+    */
+    bool extract_plan(const vector<SapID>& seq, Plan &plan,
+                      StateSequence &state_seq, VisitedStates *visited) const;
     void set_goal_state(StateID goal_state);
-    bool add_plan(Node node, bool simple_plans_only);
+    bool add_plan(NodeID node, bool simple_plans_only);
+    /*
+      add_plan() in three steps, so that plans can be extracted in other
+      threads (see PlanExtractionPipeline): prepare_candidate() returns
+      false if the plan of the node is rejected before extraction. Only
+      extract_candidate() may be called concurrently. Candidates have to be
+      committed in the order in which they were prepared; commit_candidate()
+      returns whether the plan was added.
+    */
+    bool prepare_candidate(NodeID node, bool simple_plans_only,
+                           PlanCandidate &candidate);
+    void extract_candidate(PlanCandidate &candidate,
+                           VisitedStates *visited) const;
+    bool commit_candidate(PlanCandidate &candidate);
     void dump_dot_plan(const Plan& plan);
     void clear();
     int get_last_added_plan_cost() const;
-    void add_plan_explicit_no_check(Plan plan);
+    // Adds the plan of the search tree path to the goal state
+    void add_plan_explicit_no_check();
 
-    void dump_plans_json(std::ostream& os, bool dump_states) const;
+    void add_plan_sink(std::unique_ptr<PlanSink> sink);
+    void finish_plan_sinks();
     size_t number_of_plans_found() const {return number_of_kept_plans; }
 
 };
@@ -0,0 +1,278 @@
+#include "plan_sink.h"
+
+#include "../globals.h"
+#include "../state_registry.h"
+#include "../utils/system.h"
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <iostream>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+
+namespace kstar {
+static const char BINARY_PLAN_LOG_MAGIC[4] = {'K', 'S', 'P', 'L'};
+static const int32_t BINARY_PLAN_LOG_VERSION = 2;
+static const size_t BINARY_PLAN_LOG_HEADER_SIZE =
+    sizeof(BINARY_PLAN_LOG_MAGIC) + sizeof(int32_t) + 2 * sizeof(uint64_t);
+static const size_t BINARY_PLAN_LOG_MIN_CAPACITY = 1 << 20;
+
+static void open_or_exit(ofstream &file, const string &filename) {
+    file.open(filename);
+    if (!file) {
+        cerr << "Could not open plan file " << filename << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+}
+
+void PlanFilesSink::add_plan(const Plan &plan, const StateSequence &, int) {
+    save_plan(plan, true);
+}
+
+
+int StateTable::insert(StateID state) {
+    size_t id = state.hash();
+    if (id >= state_indices.size())
+        state_indices.resize(id + 1, -1);
+    if (state_indices[id] == -1) {
+        state_indices[id] = states.size();
+        states.push_back(state);
+    }
+    return state_indices[id];
+}
+
+
+JsonPlanWriter::JsonPlanWriter(const StateRegistry &state_registry,
+                               const PddlStrings &pddl_strings,
+                               bool dump_states, bool use_state_table,
+                               bool single_line)
+    : state_registry(state_registry),
+      pddl_strings(pddl_strings),
+      dump_states(dump_states),
+      use_state_table(use_state_table),
+      single_line(single_line) {
+}
+
+size_t JsonPlanWriter::add_to_state_table(const StateSequence &states) {
+    size_t old_size = state_table.get_states().size();
+    for (StateID state : states) {
+        state_table.insert(state);
+    }
+    return old_size;
+}
+
+void JsonPlanWriter::write_state(StateID state, ostream &os) const {
+    pddl_strings.write_state(state_registry.lookup_state(state), single_line,
+                             os);
+}
+
+void JsonPlanWriter::write_plan(const Plan &plan, const StateSequence &states,
+                                int cost, ostream &os) {
+    assert(states.size() == plan.size() + 1);
+    const char *newline = single_line ? "" : "\n";
+    os << "{ ";
+    os << "\"cost\" : " << cost << "," << newline;
+    os << "\"actions\" : [" << newline;
+    for (size_t i = 0; i < plan.size(); ++i) {
+        if (i > 0)
+            os << ", ";
+        os << pddl_strings.get_operator_name(plan[i]);
+    }
+    os << "]";
+    if (uses_state_table()) {
+        os << "," << newline;
+        os << "\"states\" : [";
+        for (size_t i = 0; i < states.size(); ++i) {
+            if (i > 0)
+                os << ", ";
+            os << state_table.insert(states[i]);
+        }
+        os << "]";
+    } else if (dump_states) {
+        os << "," << newline;
+        os << "\"states\" : [" << newline;
+        for (size_t i = 0; i < states.size(); ++i) {
+            if (i > 0)
+                os << "," << newline;
+            write_state(states[i], os);
+        }
+        os << "]";
+    }
+    os << "}" << newline;
+}
+
+
+JsonPlansSink::JsonPlansSink(const string &filename,
+                             const StateRegistry &state_registry,
+                             const PddlStrings &pddl_strings,
+                             bool dump_states, bool use_state_table)
+    : writer(state_registry, pddl_strings, dump_states, use_state_table,
+             false),
+      first_plan(true),
+      end_of_plans(-1) {
+    open_or_exit(file, filename);
+    file << "{ \"plans\" : [" << endl;
+}
+
+void JsonPlansSink::add_plan(const Plan &plan, const StateSequence &states,
+                             int cost) {
+    if (end_of_plans != -1) {
+        file.seekp(end_of_plans);
+        end_of_plans = -1;
+    }
+    if (!first_plan)
+        file << "," << endl;
+    first_plan = false;
+    writer.write_plan(plan, states, cost, file);
+}
+
+void JsonPlansSink::finish() {
+    if (end_of_plans != -1)
+        return;
+    end_of_plans = file.tellp();
+    file << "]";
+    if (writer.uses_state_table()) {
+        file << "," << endl << "\"states\" : [" << endl;
+        const vector<StateID> &table_states = writer.get_table_states();
+        for (size_t i = 0; i < table_states.size(); ++i) {
+            if (i > 0)
+                file << "," << endl;
+            writer.write_state(table_states[i], file);
+        }
+        file << "]";
+    }
+    file << "}" << endl;
+}
+
+
+JsonLinesPlanSink::JsonLinesPlanSink(const string &filename,
+                                     const StateRegistry &state_registry,
+                                     const PddlStrings &pddl_strings,
+                                     bool dump_states, bool use_state_table)
+    : writer(state_registry, pddl_strings, dump_states, use_state_table,
+             true) {
+    open_or_exit(file, filename);
+}
+
+void JsonLinesPlanSink::add_plan(const Plan &plan, const StateSequence &states,
+                                 int cost) {
+    if (writer.uses_state_table()) {
+        size_t first_new = writer.add_to_state_table(states);
+        const vector<StateID> &table_states = writer.get_table_states();
+        for (size_t i = first_new; i < table_states.size(); ++i) {
+            file << "{ \"state\" : " << i << ", \"facts\" : ";
+            writer.write_state(table_states[i], file);
+            file << "}\n";
+        }
+    }
+    writer.write_plan(plan, states, cost, file);
+    file << '\n';
+    file.flush();
+}
+
+
+#if OPERATING_SYSTEM == WINDOWS
+BinaryPlanLogSink::BinaryPlanLogSink(const string &filename)
+    : filename(filename), fd(-1), data(nullptr), capacity(0), size(0),
+      num_plans(0) {
+    cerr << "The binary plan log is not supported on Windows." << endl;
+    utils::exit_with(utils::ExitCode::UNSUPPORTED);
+}
+
+BinaryPlanLogSink::~BinaryPlanLogSink() {
+}
+
+void BinaryPlanLogSink::reserve(size_t) {
+}
+
+void BinaryPlanLogSink::finish() {
+}
+#else
+BinaryPlanLogSink::BinaryPlanLogSink(const string &filename)
+    : filename(filename), fd(-1), data(nullptr), capacity(0), size(0),
+      num_plans(0) {
+    fd = open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1) {
+        cerr << "Could not open plan file " << filename << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+    reserve(BINARY_PLAN_LOG_MIN_CAPACITY);
+    memcpy(data, BINARY_PLAN_LOG_MAGIC, sizeof(BINARY_PLAN_LOG_MAGIC));
+    size = BINARY_PLAN_LOG_HEADER_SIZE;
+    update_header();
+}
+
+BinaryPlanLogSink::~BinaryPlanLogSink() {
+    finish();
+    if (fd != -1)
+        close(fd);
+}
+
+void BinaryPlanLogSink::reserve(size_t min_capacity) {
+    if (min_capacity <= capacity)
+        return;
+    size_t new_capacity = max(capacity, BINARY_PLAN_LOG_MIN_CAPACITY);
+    while (new_capacity < min_capacity)
+        new_capacity *= 2;
+    if (data)
+        munmap(data, capacity);
+    if (ftruncate(fd, new_capacity) == -1) {
+        cerr << "Could not grow plan file " << filename << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+    void *mapping = mmap(nullptr, new_capacity, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+    if (mapping == MAP_FAILED) {
+        cerr << "Could not map plan file " << filename << endl;
+        utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
+    }
+    data = static_cast<char *>(mapping);
+    capacity = new_capacity;
+}
+
+// The file stays open, reserve() maps it again for further plans.
+void BinaryPlanLogSink::finish() {
+    if (!data)
+        return;
+    munmap(data, capacity);
+    data = nullptr;
+    capacity = 0;
+    if (ftruncate(fd, size) == -1) {
+        cerr << "Could not truncate plan file " << filename << endl;
+    }
+}
+#endif
+
+void BinaryPlanLogSink::write_int(int value) {
+    memcpy(data + size, &value, sizeof(int));
+    size += sizeof(int);
+}
+
+void BinaryPlanLogSink::update_header() {
+    char *pos = data + sizeof(BINARY_PLAN_LOG_MAGIC);
+    memcpy(pos, &BINARY_PLAN_LOG_VERSION, sizeof(int32_t));
+    pos += sizeof(int32_t);
+    uint64_t counts[2] = {static_cast<uint64_t>(num_plans),
+                          size - BINARY_PLAN_LOG_HEADER_SIZE};
+    memcpy(pos, counts, sizeof(counts));
+}
+
+void BinaryPlanLogSink::add_plan(const Plan &plan, const StateSequence &,
+                                 int cost) {
+    reserve(size + (plan.size() + 2) * sizeof(int));
+    write_int(cost);
+    write_int(plan.size());
+    for (const GlobalOperator *op : plan) {
+        write_int(op->get_index());
+    }
+    ++num_plans;
+    update_header();
+}
+}
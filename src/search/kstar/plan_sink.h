@@ -0,0 +1,166 @@
+#ifndef KSTAR_PLAN_SINK_H
+#define KSTAR_PLAN_SINK_H
+
+#include "kstar_types.h"
+#include "pddl_strings.h"
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+class StateRegistry;
+
+/*
+  A PlanSink receives every plan as soon as it is accepted by the plan
+  reconstructor. Sinks write plans out instead of keeping them, so memory
+  does not grow with the number of plans and consumers can read plans
+  while the search is still running. finish() is called whenever the
+  search returns and has to leave the output complete. A resumed search
+  (see KStar::continue_search) may add further plans afterwards.
+
+  Along with every plan, sinks get the states it visits from the initial
+  state on (one more than the plan has operators), as reconstructed by the
+  plan reconstructor.
+*/
+namespace kstar {
+class PlanSink {
+public:
+    virtual ~PlanSink() = default;
+    virtual void add_plan(const Plan &plan, const StateSequence &states,
+                          int cost) = 0;
+    virtual void finish() {}
+};
+
+// Legacy layout: one file found_plans/<plan file>.N per plan.
+class PlanFilesSink : public PlanSink {
+public:
+    virtual void add_plan(const Plan &plan, const StateSequence &states,
+                          int cost) override;
+};
+
+/*
+  Numbers the states of the dumped plans in the order in which they are
+  first seen, so that a state shared by many plans is written only once.
+*/
+class StateTable {
+    // Indexed by StateID::hash(), -1 for states not in the table
+    std::vector<int> state_indices;
+    std::vector<StateID> states;
+public:
+    // Returns the index of the state, adding it if it is new
+    int insert(StateID state);
+    const std::vector<StateID> &get_states() const {
+        return states;
+    }
+};
+
+/*
+  Writes plans as JSON objects { "cost" : ..., "actions" : [...] }. With
+  dump_states, the objects also have a field "states": either the facts
+  of every state of the plan, or, with a state table, the indices of the
+  states in the table. The table itself is written by the sinks.
+*/
+class JsonPlanWriter {
+    const StateRegistry &state_registry;
+    const PddlStrings &pddl_strings;
+    bool dump_states;
+    bool use_state_table;
+    // Unless set, plans and states are spread over several lines
+    bool single_line;
+    StateTable state_table;
+public:
+    JsonPlanWriter(const StateRegistry &state_registry,
+                   const PddlStrings &pddl_strings, bool dump_states,
+                   bool use_state_table, bool single_line);
+
+    bool uses_state_table() const {
+        return dump_states && use_state_table;
+    }
+    // Adds the states to the table and returns the number of states in the
+    // table before
+    size_t add_to_state_table(const StateSequence &states);
+    const std::vector<StateID> &get_table_states() const {
+        return state_table.get_states();
+    }
+    void write_state(StateID state, std::ostream &os) const;
+    void write_plan(const Plan &plan, const StateSequence &states, int cost,
+                    std::ostream &os);
+};
+
+/*
+  The format of json_file_to_dump: a single object { "plans" : [...] }.
+  With a state table, the object has a second field "states" with the
+  facts of the states the plans refer to. Plans are written as they come,
+  the object is closed (and the state table written) by finish(). Plans
+  added after finish() overwrite everything written by finish().
+*/
+class JsonPlansSink : public PlanSink {
+    std::ofstream file;
+    JsonPlanWriter writer;
+    bool first_plan;
+    // Position of the output of finish(), or -1
+    std::streamoff end_of_plans;
+public:
+    JsonPlansSink(const std::string &filename,
+                  const StateRegistry &state_registry,
+                  const PddlStrings &pddl_strings, bool dump_states,
+                  bool use_state_table);
+    virtual void add_plan(const Plan &plan, const StateSequence &states,
+                          int cost) override;
+    virtual void finish() override;
+};
+
+/*
+  One JSON object per line (same fields as in JsonPlansSink). The file is
+  flushed after every plan, so it can be followed while K* is running.
+  With a state table, every state is written on a line of its own,
+  { "state" : <index>, "facts" : [...] }, before the first plan that
+  refers to it.
+*/
+class JsonLinesPlanSink : public PlanSink {
+    std::ofstream file;
+    JsonPlanWriter writer;
+public:
+    JsonLinesPlanSink(const std::string &filename,
+                      const StateRegistry &state_registry,
+                      const PddlStrings &pddl_strings, bool dump_states,
+                      bool use_state_table);
+    virtual void add_plan(const Plan &plan, const StateSequence &states,
+                          int cost) override;
+};
+
+/*
+  Append-only binary plan log, written through a memory mapping of the
+  file. All numbers are in native byte order:
+
+    header: magic "KSPL", version (32-bit), number of plans (64-bit),
+            size of the records in bytes, excluding the header (64-bit)
+    record: cost, length, operator indices (length many), all 32-bit
+
+  Operator indices refer to the operators of the translated task. The
+  header is updated after each record, so a reader that maps the file
+  concurrently always sees complete records. The file is grown in chunks
+  and truncated to its actual size by finish() and on destruction.
+*/
+class BinaryPlanLogSink : public PlanSink {
+    std::string filename;
+    int fd;
+    char *data;
+    size_t capacity;
+    size_t size;
+    int64_t num_plans;
+
+    void reserve(size_t min_capacity);
+    void write_int(int value);
+    void update_header();
+public:
+    explicit BinaryPlanLogSink(const std::string &filename);
+    virtual ~BinaryPlanLogSink() override;
+    virtual void add_plan(const Plan &plan, const StateSequence &states,
+                          int cost) override;
+    virtual void finish() override;
+};
+}
+
+#endif
@@ -0,0 +1,91 @@
+#include "sequence_set.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace kstar {
+static const int MIN_TABLE_SIZE = 1024;
+
+SequenceSet::SequenceSet()
+    : table(MIN_TABLE_SIZE),
+      num_entries(0),
+      offsets(1, 0) {
+}
+
+uint64_t SequenceSet::compute_hash(const vector<int> &sequence) {
+    uint64_t hash = sequence.size();
+    for (int element : sequence) {
+        // splitmix64 step on the previous hash and the element
+        uint64_t x = hash + static_cast<uint32_t>(element) +
+                     0x9e3779b97f4a7c15ULL;
+        x = (x ^ (x >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        x = (x ^ (x >> 27)) * 0x94d049bb133111ebULL;
+        hash = x ^ (x >> 31);
+    }
+    return hash;
+}
+
+bool SequenceSet::is_same_sequence(int64_t stored_sequence,
+                                   const vector<int> &sequence) const {
+    size_t begin = offsets[stored_sequence];
+    size_t end = offsets[stored_sequence + 1];
+    return end - begin == sequence.size() &&
+           equal(sequence.begin(), sequence.end(), elements.begin() + begin);
+}
+
+void SequenceSet::insert_entry(const Entry &entry) {
+    size_t mask = table.size() - 1;
+    size_t pos = entry.hash & mask;
+    while (table[pos].sequence != EMPTY) {
+        pos = (pos + 1) & mask;
+    }
+    table[pos] = entry;
+    ++num_entries;
+}
+
+void SequenceSet::grow() {
+    vector<Entry> old_table(table.size() * 2);
+    old_table.swap(table);
+    num_entries = 0;
+    for (const Entry &entry : old_table) {
+        if (entry.sequence != EMPTY)
+            insert_entry(entry);
+    }
+}
+
+bool SequenceSet::insert(const vector<int> &sequence) {
+    Entry entry;
+    entry.hash = compute_hash(sequence);
+    size_t mask = table.size() - 1;
+    for (size_t pos = entry.hash & mask; table[pos].sequence != EMPTY;
+         pos = (pos + 1) & mask) {
+        if (table[pos].hash == entry.hash &&
+            is_same_sequence(table[pos].sequence, sequence)) {
+            return false;
+        }
+    }
+
+    entry.sequence = offsets.size() - 1;
+    elements.insert(elements.end(), sequence.begin(), sequence.end());
+    offsets.push_back(elements.size());
+    // Keep the load factor at most 1/2.
+    if (2 * (num_entries + 1) > static_cast<int64_t>(table.size()))
+        grow();
+    insert_entry(entry);
+    return true;
+}
+
+void SequenceSet::clear() {
+    vector<Entry>(MIN_TABLE_SIZE).swap(table);
+    num_entries = 0;
+    vector<int>().swap(elements);
+    vector<size_t>(1, 0).swap(offsets);
+}
+
+size_t SequenceSet::get_memory_usage() const {
+    return table.capacity() * sizeof(Entry) +
+           elements.capacity() * sizeof(int) +
+           offsets.capacity() * sizeof(size_t);
+}
+}
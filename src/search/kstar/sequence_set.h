@@ -0,0 +1,50 @@
+#ifndef KSTAR_SEQUENCE_SET_H
+#define KSTAR_SEQUENCE_SET_H
+
+#include <cstdint>
+#include <vector>
+
+/*
+  SequenceSet stores sequences of integers exactly. The sequences are
+  concatenated in one vector, so that a sequence takes the space of its
+  elements plus an offset, instead of a vector and a hash set node of its
+  own. A flat hash table with open addressing (linear probing) refers to
+  the sequences by their hash. Equal hashes are only candidates: the
+  sequences are then compared element by element.
+*/
+namespace kstar {
+class SequenceSet {
+    static const int64_t EMPTY = -1;
+
+    struct Entry {
+        uint64_t hash;
+        // Index into offsets or EMPTY for unused slots
+        int64_t sequence;
+
+        Entry() : hash(0), sequence(EMPTY) {
+        }
+    };
+
+    std::vector<Entry> table;
+    int64_t num_entries;
+    // Sequence i is stored at offsets[i] and ends at offsets[i + 1].
+    std::vector<int> elements;
+    std::vector<size_t> offsets;
+
+    static uint64_t compute_hash(const std::vector<int> &sequence);
+    bool is_same_sequence(int64_t stored_sequence,
+                          const std::vector<int> &sequence) const;
+    void insert_entry(const Entry &entry);
+    void grow();
+
+public:
+    SequenceSet();
+
+    // Returns true if the sequence was not in the set before.
+    bool insert(const std::vector<int> &sequence);
+    void clear();
+    size_t get_memory_usage() const;
+};
+}
+
+#endif
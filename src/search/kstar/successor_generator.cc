@@ -5,154 +5,124 @@ using namespace std;
 
 namespace kstar {
 
-SuccessorGenerator::SuccessorGenerator(PerStateInformation<vector<Sap>> &tree_heap,
-                                       PerStateInformation<vector<Sap>> &incoming_heap,
-                                          std::unordered_map<Node, Node> &parent_sap,
-                                       std::unordered_set<Edge> &cross_edge,
+SuccessorGenerator::SuccessorGenerator(const SapArena &saps,
+                                       TreeHeap &tree_heap_nodes,
+                                       PerStateInformation<TreeHeapInfo> &tree_heap,
+                                       InHeap &in_heap_nodes,
                                        StateRegistry* state_registry) :
+                                               saps(saps),
+                                               tree_heap_nodes(tree_heap_nodes),
                                                tree_heap(tree_heap),
-                                               incomming_heap(incoming_heap),
-                                               parent_node(parent_sap),
-                                               cross_edge(cross_edge),
+                                               in_heap_nodes(in_heap_nodes),
                                                state_registry(state_registry) {
 }
 
 // For each node carrying an edge (u,v) we attach a pointer referring
 // to R(u) = top node of H_T[u]
-void SuccessorGenerator::add_cross_edge(Node &node,
-                                        vector<Node> &successors,
-                                        bool successors_only) {
+void SuccessorGenerator::add_cross_edge(NodeID node_id, const Node &node,
+                                        vector<Node> &successors) {
 
-    GlobalState u = state_registry->lookup_state(node.sap->from);
-    if (tree_heap[u].empty())
+    GlobalState u = state_registry->lookup_state(saps[node.sap].from);
+    int root = tree_heap[u].root;
+    if (root == TreeHeap::NO_NODE)
         return;
-    int succ_g = node.g + get_cost_cross_edge(tree_heap[u].front());
-    Node succ_node(succ_g, tree_heap[u].front(), u.get_id());
-
-    if (!successors_only) {
-        succ_node.id = g_djkstra_nodes;
-        ++g_djkstra_nodes;
-        set_parent(node, succ_node, true);
-    }
-
+    int in_root = tree_heap_nodes[root].value;
+    int succ_g = node.g + tree_heap_nodes[root].key;
+    Node succ_node(succ_g, in_heap_nodes[in_root].value, u.get_id());
+    succ_node.tree_heap_node = root;
+    succ_node.in_heap_node = in_root;
+    succ_node.parent = node_id;
+    succ_node.is_cross_edge = true;
     successors.push_back(succ_node);
 }
 
-// Aljazzar and Leue: edge (u,v)
-// root_in(v) keeps its only child from H_in (v).
-void SuccessorGenerator::add_inheap_successors(Node &node,
-                                               vector<Node> &successors,
-                                               bool successors_only){
-    GlobalState s  = node.sap->get_to_state();
-    for (size_t i = 1; i < incomming_heap[s].size(); ++i) {
-        Sap &sap = incomming_heap[s][i];
-        int succ_g = node.g + get_cost_heap_edge(node.sap, sap);
-        Node succ_node(succ_g, sap, node.heap_state);
-        if (!successors_only) {
-            succ_node.is_inheap_node = true;
-            succ_node.id = g_djkstra_nodes;
-            ++g_djkstra_nodes;
-            set_parent(node, succ_node, false);
-        }
-
+// The children of a node in the incoming heap H_in[v] of its edge (u,v)
+void SuccessorGenerator::add_inheap_successors(NodeID node_id, const Node &node,
+                                               vector<Node> &successors) {
+    const InHeap::HeapNode &heap_node = in_heap_nodes[node.in_heap_node];
+    for (int child : {heap_node.left, heap_node.right}) {
+        if (child == InHeap::NO_NODE)
+            continue;
+        const InHeap::HeapNode &child_node = in_heap_nodes[child];
+        assert(child_node.key >= heap_node.key);
+        int succ_g = node.g + child_node.key - heap_node.key;
+        Node succ_node(succ_g, child_node.value, node.heap_state);
+        succ_node.in_heap_node = child;
+        succ_node.parent = node_id;
         successors.push_back(succ_node);
     }
 }
 
-// Checks whether node is the root of the incomming
-// heap for its corresponding heap_state
-bool SuccessorGenerator::is_inheap_top(Node &node) {
-    GlobalState s = node.sap->get_to_state();
-    if (node.sap == incomming_heap[s].front())
-        return true;
-    return false;
-}
-
-// check whether node is the root of the treeheap
-bool SuccessorGenerator::is_treeheap_top(Node &node) {
-    GlobalState s = state_registry->lookup_state(node.heap_state);
-    if (node.sap == tree_heap[s].front())
-        return true;
-    return false;
-}
-
-void SuccessorGenerator::add_treeheap_successors(Node &node,
-                                                 vector<Node> &successors,
-                                                 bool successors_only) {
-    GlobalState s = state_registry->lookup_state(node.heap_state);
-    for (size_t i = 1; i < tree_heap[s].size(); ++i) {
-        Sap &sap = tree_heap[s][i];
-        int succ_g = node.g + get_cost_heap_edge(node.sap, sap);
-        Node succ_node(succ_g, sap, s.get_id());
-        if (!successors_only) {
-            succ_node.id = g_djkstra_nodes;
-            ++g_djkstra_nodes;
-            set_parent(node, succ_node, false);
-        }
-
+// The children of a node in the (persistent) tree heap H_T[heap_state]
+void SuccessorGenerator::add_treeheap_successors(NodeID node_id, const Node &node,
+                                                 vector<Node> &successors) {
+    const TreeHeap::HeapNode &heap_node = tree_heap_nodes[node.tree_heap_node];
+    for (int child : {heap_node.left, heap_node.right}) {
+        if (child == TreeHeap::NO_NODE)
+            continue;
+        const TreeHeap::HeapNode &child_node = tree_heap_nodes[child];
+        assert(child_node.key >= heap_node.key);
+        int succ_g = node.g + child_node.key - heap_node.key;
+        Node succ_node(succ_g, in_heap_nodes[child_node.value].value,
+                       node.heap_state);
+        succ_node.tree_heap_node = child;
+        succ_node.in_heap_node = child_node.value;
+        succ_node.parent = node_id;
         successors.push_back(succ_node);
     }
 }
 
-void SuccessorGenerator::get_successors(Node &node,
-                                        vector<Node> &successors,
-                                        bool successors_only) {
+void SuccessorGenerator::get_successors(NodeID node_id, const Node &node,
+                                        vector<Node> &successors) {
 
-    add_cross_edge(node, successors, successors_only);
-    if (is_inheap_top(node)) {
-        add_inheap_successors(node, successors, successors_only);
+    add_cross_edge(node_id, node, successors);
+    if (node.in_heap_node != InHeap::NO_NODE) {
+        add_inheap_successors(node_id, node, successors);
     }
 
-    if (is_treeheap_top(node) && !node.is_inheap_node) {
-        add_treeheap_successors(node, successors, successors_only);
+    if (node.tree_heap_node != TreeHeap::NO_NODE) {
+        add_treeheap_successors(node_id, node, successors);
     }
 }
 
 
-int SuccessorGenerator::get_max_successor_delta(Node& node,
-                                                shared_ptr<Node> pg_root) {
-    GlobalState s = state_registry->lookup_state(node.sap->to);
+/*
+  The delta of a successor is the key of its heap node, so the largest delta
+  is found without generating the successors: it is the key of the root of
+  H_T(u) for the cross edge or the key of a child of the heap nodes of the
+  node. Heap nodes never change, only the root of H_T(u) may.
+*/
+int SuccessorGenerator::get_max_successor_delta(const Node &node,
+                                                StateID goal_state) const {
+    StateID cross_state = node.sap == -1 ? goal_state : saps[node.sap].from;
     int max = -1;
-    vector<Node> successors;
-
-    // is root node
-    if(node.sap->from == StateID::no_state) {
-        Node succ;
-        get_successor_pg_root(pg_root, succ, true);
-        successors.push_back(succ);
+    int root = tree_heap[state_registry->lookup_state(cross_state)].root;
+    if (root != TreeHeap::NO_NODE) {
+        max = tree_heap_nodes[root].key;
     }
-    else {
-        get_successors(node, successors, true);
+    if (node.in_heap_node != InHeap::NO_NODE) {
+        max = std::max(max, in_heap_nodes.get_max_child_key(node.in_heap_node));
     }
-
-    for(auto succ : successors) {
-        if (succ.sap->get_delta() > max) {
-            max = succ.sap->get_delta();
-        }
+    if (node.tree_heap_node != TreeHeap::NO_NODE) {
+        max = std::max(max,
+                       tree_heap_nodes.get_max_child_key(node.tree_heap_node));
     }
     return max;
 }
 
-void SuccessorGenerator::set_parent(Node &node, Node succ_node, bool is_cross_edge) {
-    parent_node.insert(pair<Node, Node>(succ_node, node));
-    if (is_cross_edge) {
-        Edge e(node, succ_node);
-        cross_edge.insert(e);
-    }
-}
-
-void SuccessorGenerator::get_successor_pg_root(shared_ptr<Node> pg_root,
-                                               Node &successor, bool successor_only) {
-    StateID goal_id = pg_root->sap->to;
-    GlobalState goal_state = state_registry->lookup_state(goal_id);
-    Sap succ_sap = tree_heap[goal_state].front();
-    int succ_g = pg_root->g + get_cost_cross_edge(succ_sap);
-    successor = Node(succ_g, succ_sap, goal_id);
-    if (successor_only)
-        return;
-    successor.id = g_djkstra_nodes;
-
-    set_parent(*pg_root, successor ,true);
-    ++g_djkstra_nodes;
+void SuccessorGenerator::get_successor_pg_root(NodeID root_id,
+                                               const Node &pg_root,
+                                               StateID goal_state,
+                                               Node &successor) {
+    GlobalState goal = state_registry->lookup_state(goal_state);
+    int root = tree_heap[goal].root;
+    assert(root != TreeHeap::NO_NODE);
+    int in_root = tree_heap_nodes[root].value;
+    int succ_g = pg_root.g + tree_heap_nodes[root].key;
+    successor = Node(succ_g, in_heap_nodes[in_root].value, goal_state);
+    successor.tree_heap_node = root;
+    successor.in_heap_node = in_root;
+    successor.parent = root_id;
+    successor.is_cross_edge = true;
 }
 }
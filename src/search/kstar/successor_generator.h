@@ -6,35 +6,32 @@
 namespace kstar {
 
 class SuccessorGenerator {
-    PerStateInformation<vector<Sap>> &tree_heap;
-    PerStateInformation<vector<Sap>> &incomming_heap;
-    std::unordered_map<Node, Node> &parent_node;
-    std::unordered_set<Edge> &cross_edge;
+    const SapArena &saps;
+    TreeHeap &tree_heap_nodes;
+    PerStateInformation<TreeHeapInfo> &tree_heap;
+    InHeap &in_heap_nodes;
     StateRegistry* state_registry;
 
 public:
-    SuccessorGenerator(PerStateInformation<vector<Sap>> &tree_heap,
-                       PerStateInformation<vector<Sap>> &incoming_heap,
-                       std::unordered_map<Node, Node> &parent_sap,
-                       std::unordered_set<Edge> &cross_edge,
+    SuccessorGenerator(const SapArena &saps,
+                       TreeHeap &tree_heap_nodes,
+                       PerStateInformation<TreeHeapInfo> &tree_heap,
+                       InHeap &in_heap_nodes,
                        StateRegistry* state_registry);
 
     virtual ~SuccessorGenerator() = default;
-    void get_successor_pg_root(shared_ptr<Node> pg_root,
-                               Node &successor, bool successor_only = false);
-    void set_parent(Node &node, Node succ_node, bool is_cross_edge);
-
-    void get_successors(Node &sap, vector<Node> &successor_sap,
-                        bool successors_only = false);
-    int get_max_successor_delta(Node& sap, shared_ptr<Node> pg_root);
-    void add_cross_edge(Node &p, vector<Node> &successors,
-                        bool successors_only = false);
-       void add_inheap_successors(Node &node, vector<Node> &successors,
-                               bool successor_only = false);
-    void add_treeheap_successors(Node &node, vector<Node> &successors,
-                               bool successor_only = false);
-    bool is_inheap_top(Node &node);
-    bool is_treeheap_top(Node &node);
+    // The successors refer to node_id as their parent
+    void get_successor_pg_root(NodeID root_id, const Node &pg_root,
+                               StateID goal_state, Node &successor);
+    void get_successors(NodeID node_id, const Node &node,
+                        vector<Node> &successors);
+    int get_max_successor_delta(const Node &node, StateID goal_state) const;
+    void add_cross_edge(NodeID node_id, const Node &node,
+                        vector<Node> &successors);
+    void add_inheap_successors(NodeID node_id, const Node &node,
+                               vector<Node> &successors);
+    void add_treeheap_successors(NodeID node_id, const Node &node,
+                                 vector<Node> &successors);
 };
 }
 #endif
@@ -53,6 +53,10 @@ public:
 
     virtual ~LamaMasterHeuristic() override = default;
 
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::SERIAL;
+    }
+
     virtual EvaluationResult compute_result(
         EvaluationContext &eval_context) override {
         synergy->compute_heuristics(eval_context);
@@ -108,6 +112,10 @@ public:
     }
 
     virtual ~FFSlaveHeuristic() override = default;
+
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::SERIAL;
+    }
 };
 
 
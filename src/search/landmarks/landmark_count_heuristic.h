@@ -52,6 +52,9 @@ public:
                                          const GlobalOperator &op,
                                          const GlobalState &state) override;
     virtual bool dead_ends_are_reliable() const override;
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::SERIAL;
+    }
 };
 }
 
@@ -6,6 +6,7 @@
 #include "transition_system.h"
 
 #include "../utils/memory.h"
+#include "../utils/thread_pool.h"
 
 #include <cassert>
 
@@ -37,6 +38,7 @@ FactoredTransitionSystem::FactoredTransitionSystem(
     vector<unique_ptr<TransitionSystem>> &&transition_systems,
     vector<unique_ptr<MergeAndShrinkRepresentation>> &&mas_representations,
     vector<unique_ptr<Distances>> &&distances,
+    utils::ThreadPool &thread_pool,
     Verbosity verbosity,
     bool finalize_if_unsolvable)
     : labels(move(labels)),
@@ -44,8 +46,28 @@ FactoredTransitionSystem::FactoredTransitionSystem(
       mas_representations(move(mas_representations)),
       distances(move(distances)),
       unsolvable_index(-1),
-      num_active_entries(this->transition_systems.size()) {
-    for (size_t i = 0; i < this->transition_systems.size(); ++i) {
+      num_active_entries(this->transition_systems.size()),
+      thread_pool(thread_pool) {
+    int num_entries = this->transition_systems.size();
+    if (thread_pool.get_num_threads() > 1) {
+        /*
+          Unlike the serial loop below, this also computes the distances of
+          the entries after the first unsolvable one, but these are never
+          used.
+        */
+        thread_pool.run(num_entries, [&](int index, int) {
+                            compute_distances_and_prune(index, verbosity);
+                        });
+        for (int i = 0; i < num_entries; ++i) {
+            if (finalize_if_unsolvable &&
+                !this->transition_systems[i]->is_solvable()) {
+                unsolvable_index = i;
+                break;
+            }
+        }
+        return;
+    }
+    for (int i = 0; i < num_entries; ++i) {
         compute_distances_and_prune(i, verbosity);
         if (finalize_if_unsolvable && !this->transition_systems[i]->is_solvable()) {
             unsolvable_index = i;
@@ -60,7 +82,8 @@ FactoredTransitionSystem::FactoredTransitionSystem(FactoredTransitionSystem &&ot
       mas_representations(move(other.mas_representations)),
       distances(move(other.distances)),
       unsolvable_index(move(other.unsolvable_index)),
-      num_active_entries(move(other.num_active_entries)) {
+      num_active_entries(move(other.num_active_entries)),
+      thread_pool(other.thread_pool) {
     /*
       This is just a default move constructor. Unfortunately Visual
       Studio does not support "= default" for move construction or
@@ -172,34 +195,68 @@ int FactoredTransitionSystem::merge(
     int index2,
     Verbosity verbosity,
     bool finalize_if_unsolvable) {
-    assert(is_index_valid(index1));
-    assert(is_index_valid(index2));
-    transition_systems.push_back(
-        TransitionSystem::merge(
-            *labels,
-            *transition_systems[index1],
-            *transition_systems[index2],
-            verbosity));
-    distances[index1] = nullptr;
-    distances[index2] = nullptr;
-    transition_systems[index1] = nullptr;
-    transition_systems[index2] = nullptr;
-    mas_representations.push_back(
-        utils::make_unique_ptr<MergeAndShrinkRepresentationMerge>(
-            move(mas_representations[index1]),
-            move(mas_representations[index2])));
-    mas_representations[index1] = nullptr;
-    mas_representations[index2] = nullptr;
-    const TransitionSystem &new_ts = *transition_systems.back();
-    distances.push_back(utils::make_unique_ptr<Distances>(new_ts));
-    int new_index = transition_systems.size() - 1;
-    compute_distances_and_prune(new_index, verbosity);
-    assert(is_component_valid(new_index));
-    if (finalize_if_unsolvable && !new_ts.is_solvable()) {
-        unsolvable_index = new_index;
+    return merge_independent(
+        {make_pair(index1, index2)}, verbosity, finalize_if_unsolvable).front();
+}
+
+vector<int> FactoredTransitionSystem::merge_independent(
+    const vector<pair<int, int>> &merges,
+    Verbosity verbosity,
+    bool finalize_if_unsolvable) {
+    int num_merges = merges.size();
+    int first_new_index = transition_systems.size();
+    /*
+      Add the new entries first, so that the merges do not change the
+      vectors concurrently.
+    */
+    for (const pair<int, int> &merge : merges) {
+        int index1 = merge.first;
+        int index2 = merge.second;
+        assert(is_index_valid(index1));
+        assert(is_index_valid(index2));
+        transition_systems.push_back(nullptr);
+        distances.push_back(nullptr);
+        mas_representations.push_back(
+            utils::make_unique_ptr<MergeAndShrinkRepresentationMerge>(
+                move(mas_representations[index1]),
+                move(mas_representations[index2])));
+        mas_representations[index1] = nullptr;
+        mas_representations[index2] = nullptr;
+    }
+
+    thread_pool.run(num_merges, [&](int i, int) {
+                        int index1 = merges[i].first;
+                        int index2 = merges[i].second;
+                        int new_index = first_new_index + i;
+                        transition_systems[new_index] = TransitionSystem::merge(
+                            *labels,
+                            *transition_systems[index1],
+                            *transition_systems[index2],
+                            verbosity);
+                        distances[new_index] = utils::make_unique_ptr<Distances>(
+                            *transition_systems[new_index]);
+                        compute_distances_and_prune(new_index, verbosity);
+                        assert(is_component_valid(new_index));
+                    });
+
+    vector<int> new_indices;
+    new_indices.reserve(num_merges);
+    for (int i = 0; i < num_merges; ++i) {
+        int index1 = merges[i].first;
+        int index2 = merges[i].second;
+        int new_index = first_new_index + i;
+        distances[index1] = nullptr;
+        distances[index2] = nullptr;
+        transition_systems[index1] = nullptr;
+        transition_systems[index2] = nullptr;
+        if (finalize_if_unsolvable && unsolvable_index == -1 &&
+            !transition_systems[new_index]->is_solvable()) {
+            unsolvable_index = new_index;
+        }
+        --num_active_entries;
+        new_indices.push_back(new_index);
     }
-    --num_active_entries;
-    return new_index;
+    return new_indices;
 }
 
 pair<unique_ptr<MergeAndShrinkRepresentation>, unique_ptr<Distances>>
@@ -4,8 +4,13 @@
 #include "types.h"
 
 #include <memory>
+#include <utility>
 #include <vector>
 
+namespace utils {
+class ThreadPool;
+}
+
 namespace merge_and_shrink {
 class Distances;
 class FactoredTransitionSystem;
@@ -48,6 +53,8 @@ class FactoredTransitionSystem {
     std::vector<std::unique_ptr<Distances>> distances;
     int unsolvable_index; // -1 if solvable, index of an unsolvable entry otw.
     int num_active_entries;
+    // Processes independent entries in parallel.
+    utils::ThreadPool &thread_pool;
 
     void compute_distances_and_prune(
         int index,
@@ -65,6 +72,7 @@ public:
         std::vector<std::unique_ptr<TransitionSystem>> &&transition_systems,
         std::vector<std::unique_ptr<MergeAndShrinkRepresentation>> &&mas_representations,
         std::vector<std::unique_ptr<Distances>> &&distances,
+        utils::ThreadPool &thread_pool,
         Verbosity verbosity,
         bool finalize_if_unsolvable);
     FactoredTransitionSystem(FactoredTransitionSystem &&other);
@@ -88,6 +96,16 @@ public:
         int index2,
         Verbosity verbosity,
         bool finalize_if_unsolvable);
+    /*
+      Performs the given merges, none of which may involve an index
+      involved in another one, in parallel. The composites are stored in
+      the order of the merges, so the result is the same as merging one
+      after the other. Returns the indices of the composites.
+    */
+    std::vector<int> merge_independent(
+        const std::vector<std::pair<int, int>> &merges,
+        Verbosity verbosity,
+        bool finalize_if_unsolvable);
     /*
       This method may only be called either when there is only one entry left
       in the FTS or when the FTS is unsolvable.
@@ -121,6 +139,11 @@ public:
         return *labels;
     }
 
+    // Used by MergeAndShrinkHeuristic and MergeScoringFunctionDFP
+    utils::ThreadPool &get_thread_pool() const {
+        return thread_pool;
+    }
+
     // The following methods are used for iterating over the FTS
     FTSConstIterator begin() const {
         return FTSConstIterator(*this, false);
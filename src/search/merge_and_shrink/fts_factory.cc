@@ -83,7 +83,10 @@ public:
       Note: create() may only be called once. We don't worry about
       misuse because the class is only used internally in this file.
     */
-    FactoredTransitionSystem create(Verbosity verbosity, bool finalize_if_unsolvable);
+    FactoredTransitionSystem create(
+        utils::ThreadPool &thread_pool,
+        Verbosity verbosity,
+        bool finalize_if_unsolvable);
 };
 
 
@@ -392,7 +395,9 @@ vector<unique_ptr<Distances>> FTSFactory::create_distances(
 }
 
 FactoredTransitionSystem FTSFactory::create(
-    Verbosity verbosity, bool finalize_if_unsolvable) {
+    utils::ThreadPool &thread_pool,
+    Verbosity verbosity,
+    bool finalize_if_unsolvable) {
     if (verbosity >= Verbosity::NORMAL) {
         cout << "Building atomic transition systems... " << endl;
     }
@@ -413,14 +418,17 @@ FactoredTransitionSystem FTSFactory::create(
         move(transition_systems),
         move(mas_representations),
         move(distances),
+        thread_pool,
         verbosity,
         finalize_if_unsolvable);
 }
 
 FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
+    utils::ThreadPool &thread_pool,
     Verbosity verbosity,
     bool finalize_if_unsolvable) {
-    return FTSFactory(task_proxy).create(verbosity, finalize_if_unsolvable);
+    return FTSFactory(task_proxy).create(
+        thread_pool, verbosity, finalize_if_unsolvable);
 }
 }
@@ -13,12 +13,17 @@
 
 class TaskProxy;
 
+namespace utils {
+class ThreadPool;
+}
+
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
 enum class Verbosity;
 
 extern FactoredTransitionSystem create_factored_transition_system(
     const TaskProxy &task_proxy,
+    utils::ThreadPool &thread_pool,
     Verbosity verbosity,
     bool finalize_if_unsolvable = true);
 }
@@ -21,10 +21,12 @@
 #include "../utils/math.h"
 #include "../utils/memory.h"
 #include "../utils/system.h"
+#include "../utils/thread_pool.h"
 #include "../utils/timer.h"
 
 #include <cassert>
 #include <iostream>
+#include <sstream>
 #include <string>
 #include <utility>
 #include <vector>
@@ -37,6 +39,12 @@ static void print_time(const utils::Timer &timer, string text) {
     cout << "t=" << timer << " (" << text << ")" << endl;
 }
 
+static string get_time(const utils::Timer &timer) {
+    ostringstream out;
+    out << timer;
+    return out.str();
+}
+
 MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
     : Heuristic(opts),
       merge_strategy_factory(opts.get<shared_ptr<MergeStrategyFactory>>("merge_strategy")),
@@ -45,12 +53,15 @@ MergeAndShrinkHeuristic::MergeAndShrinkHeuristic(const Options &opts)
       max_states(opts.get<int>("max_states")),
       max_states_before_merge(opts.get<int>("max_states_before_merge")),
       shrink_threshold_before_merge(opts.get<int>("threshold_before_merge")),
+      num_threads(opts.get<int>("construction_threads")),
       verbosity(static_cast<Verbosity>(opts.get_enum("verbosity"))),
       starting_peak_memory(-1),
       mas_representation(nullptr) {
     assert(max_states_before_merge > 0);
     assert(max_states >= max_states_before_merge);
     assert(shrink_threshold_before_merge <= max_states_before_merge);
+    if (num_threads == 0)
+        num_threads = utils::get_hardware_concurrency();
 
     if (opts.contains("label_reduction")) {
         label_reduction = opts.get<shared_ptr<LabelReduction>>("label_reduction");
@@ -100,6 +111,9 @@ void MergeAndShrinkHeuristic::dump_options() const {
     shrink_strategy->dump_options();
     cout << endl;
 
+    cout << "Construction threads: " << num_threads << endl;
+    cout << endl;
+
     if (label_reduction) {
         label_reduction->dump_options();
     } else {
@@ -155,54 +169,91 @@ void MergeAndShrinkHeuristic::warn_on_unusual_options() const {
                  << endl << dashes << endl;
         }
     }
+    if (num_threads > 1 && verbosity >= Verbosity::VERBOSE) {
+        cerr << dashes << endl
+             << "WARNING! The construction uses only one thread with "
+            "verbosity=verbose, so that the output of different\n"
+            "transition systems does not interleave. Use verbosity=normal "
+            "to run it with several threads."
+             << endl << dashes << endl;
+    }
 }
 
-pair<bool, bool> MergeAndShrinkHeuristic::shrink_before_merge(
-    FactoredTransitionSystem &fts, int index1, int index2) {
+vector<pair<bool, bool>> MergeAndShrinkHeuristic::shrink_before_merge(
+    FactoredTransitionSystem &fts, const vector<pair<int, int>> &merges) {
     /*
       Compute the size limit for both transition systems as imposed by
       max_states and max_states_before_merge.
     */
-    pair<int, int> new_sizes = compute_shrink_sizes(
-        fts.get_ts(index1).get_size(),
-        fts.get_ts(index2).get_size(),
-        max_states_before_merge,
-        max_states);
+    vector<int> indices;
+    vector<int> new_sizes;
+    for (const pair<int, int> &merge : merges) {
+        pair<int, int> merge_new_sizes = compute_shrink_sizes(
+            fts.get_ts(merge.first).get_size(),
+            fts.get_ts(merge.second).get_size(),
+            max_states_before_merge,
+            max_states);
+        indices.push_back(merge.first);
+        new_sizes.push_back(merge_new_sizes.first);
+        indices.push_back(merge.second);
+        new_sizes.push_back(merge_new_sizes.second);
+    }
 
     /*
       For both transition systems, possibly compute and apply an
-      abstraction.
+      abstraction. Different transition systems are shrunk in parallel if
+      the shrink strategy supports it.
       TODO: we could better use the given limit by increasing the size limit
       for the second shrinking if the first shrinking was larger than
       required.
     */
-    bool shrunk1 = shrink_transition_system(
-        fts,
-        index1,
-        new_sizes.first,
-        shrink_threshold_before_merge,
-        *shrink_strategy,
-        verbosity);
-    bool shrunk2 = shrink_transition_system(
-        fts,
-        index2,
-        new_sizes.second,
-        shrink_threshold_before_merge,
-        *shrink_strategy,
-        verbosity);
-    return make_pair(shrunk1, shrunk2);
+    // Not vector<bool>, which cannot be written by several threads.
+    vector<int> shrunk(indices.size(), false);
+    auto shrink = [&](int i, int) {
+            shrunk[i] = shrink_transition_system(
+                fts,
+                indices[i],
+                new_sizes[i],
+                shrink_threshold_before_merge,
+                *shrink_strategy,
+                verbosity);
+        };
+    if (shrink_strategy->can_shrink_in_parallel()) {
+        fts.get_thread_pool().run(indices.size(), shrink);
+    } else {
+        for (size_t i = 0; i < indices.size(); ++i) {
+            shrink(i, 0);
+        }
+    }
+
+    vector<pair<bool, bool>> result;
+    result.reserve(merges.size());
+    for (size_t i = 0; i < merges.size(); ++i) {
+        result.emplace_back(shrunk[2 * i], shrunk[2 * i + 1]);
+    }
+    return result;
 }
 
 void MergeAndShrinkHeuristic::build(const utils::Timer &timer) {
     const bool finalize_if_unsolvable = true;
+    utils::ThreadPool thread_pool(
+        verbosity >= Verbosity::VERBOSE ? 1 : num_threads);
     FactoredTransitionSystem fts =
         create_factored_transition_system(
             task_proxy,
+            thread_pool,
             verbosity,
             finalize_if_unsolvable);
     print_time(timer, "after computation of atomic transition systems");
     cout << endl;
 
+    /*
+      Label reduction changes all transition systems, so independent
+      merges are only performed together without it.
+    */
+    bool merge_independently =
+        !label_reduction && thread_pool.get_num_threads() > 1;
+
     if (fts.is_solvable()) { // All atomic transition system are solvable.
         unique_ptr<MergeStrategy> merge_strategy =
             merge_strategy_factory->compute_merge_strategy(task_proxy, fts);
@@ -210,67 +261,111 @@ void MergeAndShrinkHeuristic::build(const utils::Timer &timer) {
 
         while (fts.is_solvable() && fts.get_num_active_entries() > 1) {
             // Choose next transition systems to merge
-            pair<int, int> merge_indices = merge_strategy->get_next();
-            int merge_index1 = merge_indices.first;
-            int merge_index2 = merge_indices.second;
-            assert(merge_index1 != merge_index2);
-            if (verbosity >= Verbosity::NORMAL) {
-                cout << "Next pair of indices: ("
-                     << merge_index1 << ", " << merge_index2 << ")" << endl;
-                if (verbosity >= Verbosity::VERBOSE) {
-                    fts.statistics(merge_index1);
-                    fts.statistics(merge_index2);
+            vector<pair<int, int>> merges;
+            if (merge_independently) {
+                merges = merge_strategy->get_next_independent_merges();
+            } else {
+                merges.push_back(merge_strategy->get_next());
+            }
+            /*
+              The output of independent merges is printed after all of them
+              are done, merge by merge, so that the log has the same order as
+              with serial merges. Independent merges only happen below the
+              verbose level.
+            */
+            bool print_later = merges.size() > 1;
+            string time_after_computation;
+            string time_after_shrinking;
+            for (const pair<int, int> &merge : merges) {
+                assert(merge.first != merge.second);
+                if (verbosity >= Verbosity::NORMAL && !print_later) {
+                    cout << "Next pair of indices: ("
+                         << merge.first << ", " << merge.second << ")" << endl;
+                    if (verbosity >= Verbosity::VERBOSE) {
+                        fts.statistics(merge.first);
+                        fts.statistics(merge.second);
+                    }
                 }
-                print_time(timer, "after computation of next merge");
+            }
+            if (verbosity >= Verbosity::NORMAL) {
+                if (print_later)
+                    time_after_computation = get_time(timer);
+                else
+                    print_time(timer, "after computation of next merge");
             }
 
             // Label reduction (before shrinking)
             if (label_reduction && label_reduction->reduce_before_shrinking()) {
+                assert(merges.size() == 1);
                 bool reduced =
-                    label_reduction->reduce(merge_indices, fts, verbosity);
+                    label_reduction->reduce(merges.front(), fts, verbosity);
                 if (verbosity >= Verbosity::NORMAL && reduced) {
                     print_time(timer, "after label reduction");
                 }
             }
 
             // Shrinking
-            pair<bool, bool> shrunk = shrink_before_merge(
-                fts, merge_index1, merge_index2);
-            if (verbosity >= Verbosity::NORMAL &&
-                (shrunk.first || shrunk.second)) {
+            vector<pair<bool, bool>> shrunk = shrink_before_merge(fts, merges);
+            bool any_shrunk = false;
+            for (size_t i = 0; i < merges.size(); ++i) {
                 if (verbosity >= Verbosity::VERBOSE) {
-                    if (shrunk.first) {
-                        fts.statistics(merge_index1);
+                    if (shrunk[i].first) {
+                        fts.statistics(merges[i].first);
                     }
-                    if (shrunk.second) {
-                        fts.statistics(merge_index2);
+                    if (shrunk[i].second) {
+                        fts.statistics(merges[i].second);
                     }
                 }
-                print_time(timer, "after shrinking");
+                any_shrunk = any_shrunk || shrunk[i].first || shrunk[i].second;
+            }
+            if (verbosity >= Verbosity::NORMAL && any_shrunk) {
+                if (print_later)
+                    time_after_shrinking = get_time(timer);
+                else
+                    print_time(timer, "after shrinking");
             }
 
             // Label reduction (before merging)
             if (label_reduction && label_reduction->reduce_before_merging()) {
+                assert(merges.size() == 1);
                 bool reduced =
-                    label_reduction->reduce(merge_indices, fts, verbosity);
+                    label_reduction->reduce(merges.front(), fts, verbosity);
                 if (verbosity >= Verbosity::NORMAL && reduced) {
                     print_time(timer, "after label reduction");
                 }
             }
 
             // Merging
-            int merged_index = fts.merge(
-                merge_index1, merge_index2, verbosity, finalize_if_unsolvable);
+            vector<int> merged_indices = fts.merge_independent(
+                merges, verbosity, finalize_if_unsolvable);
             /*
               NOTE: both the shrinking strategy classes and the construction of
               the composite require input transition systems to be solvable.
             */
+            if (verbosity >= Verbosity::NORMAL && print_later) {
+                string time_after_merging = get_time(timer);
+                for (size_t i = 0; i < merges.size(); ++i) {
+                    cout << "Next pair of indices: (" << merges[i].first
+                         << ", " << merges[i].second << ")" << endl;
+                    cout << "t=" << time_after_computation
+                         << " (after computation of next merge)" << endl;
+                    if (shrunk[i].first || shrunk[i].second) {
+                        cout << "t=" << time_after_shrinking
+                             << " (after shrinking)" << endl;
+                    }
+                    cout << "t=" << time_after_merging
+                         << " (after merging)" << endl;
+                    cout << endl;
+                }
+            }
             if (!fts.is_solvable()) {
                 break;
             }
-            if (verbosity >= Verbosity::NORMAL) {
+            if (verbosity >= Verbosity::NORMAL && !print_later) {
                 if (verbosity >= Verbosity::VERBOSE) {
-                    fts.statistics(merged_index);
+                    for (int merged_index : merged_indices) {
+                        fts.statistics(merged_index);
+                    }
                 }
                 print_time(timer, "after merging");
                 if (verbosity >= Verbosity::VERBOSE) {
@@ -467,6 +562,17 @@ static Heuristic *_parse(OptionParser &parser) {
     MergeAndShrinkHeuristic::add_shrink_limit_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
+    parser.add_option<int>(
+        "construction_threads",
+        "Number of threads for the independent steps of the construction "
+        "(0: one per core): computing the distances of the atomic transition "
+        "systems, scoring merge candidates with DFP, shrinking with "
+        "bisimulation and, without label reduction, merging independent "
+        "pairs of a merge tree. The abstraction is the same as with one "
+        "thread. With verbosity=verbose, only one thread is used.",
+        "1",
+        Bounds("0", "infinity"));
+
     vector<string> verbosity_levels;
     vector<string> verbosity_level_docs;
     verbosity_levels.push_back("silent");
@@ -4,6 +4,8 @@
 #include "../heuristic.h"
 
 #include <memory>
+#include <utility>
+#include <vector>
 
 namespace utils {
 class Timer;
@@ -34,13 +36,25 @@ class MergeAndShrinkHeuristic : public Heuristic {
        max_states and max_states_before_merge are not violated. */
     const int shrink_threshold_before_merge;
 
+    /*
+      Number of threads for independent steps of the construction: the
+      distances of the atomic transition systems, scoring merge candidates,
+      shrinking the transition systems of a merge and, without label
+      reduction, independent merges of a merge tree.
+    */
+    int num_threads;
     const Verbosity verbosity;
     long starting_peak_memory;
     // The final merge-and-shrink representation, storing goal distances.
     std::unique_ptr<MergeAndShrinkRepresentation> mas_representation;
 
-    std::pair<bool, bool> shrink_before_merge(
-        FactoredTransitionSystem &fts, int index1, int index2);
+    /*
+      Shrinks both transition systems of every merge. Returns for every
+      merge whether the first and the second one were shrunk.
+    */
+    std::vector<std::pair<bool, bool>> shrink_before_merge(
+        FactoredTransitionSystem &fts,
+        const std::vector<std::pair<int, int>> &merges);
     void build(const utils::Timer &timer);
 
     void report_peak_memory_delta(bool final = false) const;
@@ -51,6 +65,9 @@ protected:
 public:
     explicit MergeAndShrinkHeuristic(const options::Options &opts);
     virtual ~MergeAndShrinkHeuristic() override = default;
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
     static void add_shrink_limit_options_to_parser(options::OptionParser &parser);
     static void handle_shrink_limit_options_defaults(options::Options &opts);
 };
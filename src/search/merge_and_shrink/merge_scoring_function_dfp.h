@@ -5,6 +5,11 @@
 
 namespace merge_and_shrink {
 class TransitionSystem;
+/*
+  The label ranks of the transition systems and the scores of the merge
+  candidates are computed with the thread pool of the factored transition
+  system.
+*/
 class MergeScoringFunctionDFP : public MergeScoringFunction {
     std::vector<int> compute_label_ranks(
         const FactoredTransitionSystem &fts, int index) const;
@@ -7,4 +7,8 @@ MergeStrategy::MergeStrategy(
     FactoredTransitionSystem &fts)
     : fts(fts) {
 }
+
+vector<pair<int, int>> MergeStrategy::get_next_independent_merges() {
+    return {get_next()};
+}
 }
@@ -2,6 +2,7 @@
 #define MERGE_AND_SHRINK_MERGE_STRATEGY_H
 
 #include <utility>
+#include <vector>
 
 namespace merge_and_shrink {
 class FactoredTransitionSystem;
@@ -47,6 +48,14 @@ public:
     virtual ~MergeStrategy() = default;
     // TODO: should become const
     virtual std::pair<int, int> get_next() = 0;
+    /*
+      Returns the next merges in the order in which get_next would return
+      them, as long as no merge involves the result of an earlier one, so
+      that they can be performed independently. The i-th result must be
+      stored at index fts.get_size() + i. By default, this is only the next
+      merge.
+    */
+    virtual std::vector<std::pair<int, int>> get_next_independent_merges();
 };
 }
 
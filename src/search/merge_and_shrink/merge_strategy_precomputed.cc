@@ -3,6 +3,8 @@
 #include "factored_transition_system.h"
 #include "merge_tree.h"
 
+#include "../utils/language.h"
+
 #include <cassert>
 
 using namespace std;
@@ -21,4 +23,16 @@ pair<int, int> MergeStrategyPrecomputed::get_next() {
     assert(fts.is_active(next_merge.second));
     return next_merge;
 }
+
+vector<pair<int, int>> MergeStrategyPrecomputed::get_next_independent_merges() {
+    assert(!merge_tree->done());
+    vector<pair<int, int>> next_merges =
+        merge_tree->get_next_independent_merges(fts.get_size());
+    for (const pair<int, int> &next_merge : next_merges) {
+        utils::unused_variable(next_merge);
+        assert(fts.is_active(next_merge.first));
+        assert(fts.is_active(next_merge.second));
+    }
+    return next_merges;
+}
 }
@@ -15,6 +15,7 @@ public:
         std::unique_ptr<MergeTree> merge_tree);
     virtual ~MergeStrategyPrecomputed() override = default;
     virtual std::pair<int, int> get_next() override;
+    virtual std::vector<std::pair<int, int>> get_next_independent_merges() override;
 };
 }
 
@@ -146,6 +146,22 @@ pair<int, int> MergeTree::get_next_merge(int new_index) {
     return next_merge->erase_children_and_set_index(new_index);
 }
 
+vector<pair<int, int>> MergeTree::get_next_independent_merges(int new_index) {
+    vector<pair<int, int>> merges;
+    int next_index = new_index;
+    while (!root->is_leaf()) {
+        MergeTreeNode *next_merge = root->get_left_most_sibling();
+        if (next_merge->left_child->ts_index >= new_index ||
+            next_merge->right_child->ts_index >= new_index) {
+            break;
+        }
+        merges.push_back(next_merge->erase_children_and_set_index(next_index));
+        ++next_index;
+    }
+    assert(!merges.empty());
+    return merges;
+}
+
 pair<MergeTreeNode *, MergeTreeNode *> MergeTree::get_parents_of_ts_indices(
     const pair<int, int> &ts_indices, int new_index) {
     int ts_index1 = ts_indices.first;
@@ -3,6 +3,7 @@
 
 #include <memory>
 #include <utility>
+#include <vector>
 
 namespace utils {
 class RandomNumberGenerator;
@@ -96,6 +97,13 @@ public:
         UpdateOption update_option);
     ~MergeTree();
     std::pair<int, int> get_next_merge(int new_index);
+    /*
+      Returns the next merges as get_next_merge would return them, as long
+      as none of them merges the result of an earlier one. The i-th merge
+      is given the index new_index + i. The result is never empty.
+    */
+    std::vector<std::pair<int, int>> get_next_independent_merges(
+        int new_index);
     /*
       Inform the merge tree about a merge that happened independently of
       using the tree's method get_next_merge.
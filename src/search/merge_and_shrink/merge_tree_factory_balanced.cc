@@ -0,0 +1,134 @@
+#include "merge_tree_factory_balanced.h"
+
+#include "factored_transition_system.h"
+#include "merge_tree.h"
+#include "transition_system.h"
+
+#include "../task_proxy.h"
+
+#include "../options/option_parser.h"
+#include "../options/options.h"
+#include "../options/plugin.h"
+
+#include "../utils/memory.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace merge_and_shrink {
+MergeTreeFactoryBalanced::MergeTreeFactoryBalanced(
+    const options::Options &options)
+    : MergeTreeFactory(options),
+      variable_order_type(static_cast<VariableOrderType>(
+                              options.get_enum("variable_order"))) {
+}
+
+MergeTreeNode *MergeTreeFactoryBalanced::compute_balanced_tree(
+    const vector<int> &ts_indices) {
+    assert(!ts_indices.empty());
+    vector<MergeTreeNode *> level;
+    level.reserve(ts_indices.size());
+    for (int ts_index : ts_indices)
+        level.push_back(new MergeTreeNode(ts_index));
+    while (level.size() > 1) {
+        vector<MergeTreeNode *> next_level;
+        next_level.reserve((level.size() + 1) / 2);
+        for (size_t i = 0; i + 1 < level.size(); i += 2)
+            next_level.push_back(new MergeTreeNode(level[i], level[i + 1]));
+        // An odd node is merged on the next level.
+        if (level.size() % 2 == 1)
+            next_level.push_back(level.back());
+        level.swap(next_level);
+    }
+    return level.front();
+}
+
+unique_ptr<MergeTree> MergeTreeFactoryBalanced::compute_merge_tree(
+    const TaskProxy &task_proxy) {
+    VariableOrderFinder vof(task_proxy, variable_order_type);
+    vector<int> ts_indices;
+    while (!vof.done())
+        ts_indices.push_back(vof.next());
+    return utils::make_unique_ptr<MergeTree>(
+        compute_balanced_tree(ts_indices), rng, update_option);
+}
+
+unique_ptr<MergeTree> MergeTreeFactoryBalanced::compute_merge_tree(
+    const TaskProxy &task_proxy,
+    FactoredTransitionSystem &fts,
+    const vector<int> &indices_subset) {
+    /*
+      As for linear merge trees, the transition systems of indices_subset
+      are ordered by the first of their variables in the variable order.
+    */
+    int num_vars = task_proxy.get_variables().size();
+    int num_ts = fts.get_size();
+    vector<int> var_to_ts_index(num_vars, -1);
+    vector<bool> used_ts_indices(num_ts, true);
+    for (int ts_index : fts) {
+        if (find(indices_subset.begin(), indices_subset.end(), ts_index) !=
+            indices_subset.end()) {
+            used_ts_indices[ts_index] = false;
+        }
+        for (int var : fts.get_ts(ts_index).get_incorporated_variables()) {
+            var_to_ts_index[var] = ts_index;
+        }
+    }
+
+    VariableOrderFinder vof(task_proxy, variable_order_type);
+    vector<int> ts_indices;
+    while (!vof.done()) {
+        int ts_index = var_to_ts_index[vof.next()];
+        assert(ts_index != -1);
+        if (!used_ts_indices[ts_index]) {
+            used_ts_indices[ts_index] = true;
+            ts_indices.push_back(ts_index);
+        }
+    }
+    return utils::make_unique_ptr<MergeTree>(
+        compute_balanced_tree(ts_indices), rng, update_option);
+}
+
+string MergeTreeFactoryBalanced::name() const {
+    return "balanced";
+}
+
+void MergeTreeFactoryBalanced::dump_tree_specific_options() const {
+    dump_variable_order_type(variable_order_type);
+}
+
+void MergeTreeFactoryBalanced::add_options_to_parser(
+    options::OptionParser &parser) {
+    MergeTreeFactory::add_options_to_parser(parser);
+    vector<string> variable_orders;
+    variable_orders.push_back("CG_GOAL_LEVEL");
+    variable_orders.push_back("CG_GOAL_RANDOM");
+    variable_orders.push_back("GOAL_CG_LEVEL");
+    variable_orders.push_back("RANDOM");
+    variable_orders.push_back("LEVEL");
+    variable_orders.push_back("REVERSE_LEVEL");
+    parser.add_enum_option(
+        "variable_order", variable_orders,
+        "the order of the atomic transition systems whose neighbors are "
+        "merged",
+        "CG_GOAL_LEVEL");
+}
+
+static shared_ptr<MergeTreeFactory> _parse(options::OptionParser &parser) {
+    MergeTreeFactoryBalanced::add_options_to_parser(parser);
+    parser.document_synopsis(
+        "Balanced merge trees",
+        "These merge trees merge neighbors in a variable order level by "
+        "level, so that the merges of a level can be performed in parallel "
+        "(see the option construction_threads of merge_and_shrink).");
+    options::Options opts = parser.parse();
+    if (parser.dry_run())
+        return nullptr;
+    else
+        return make_shared<MergeTreeFactoryBalanced>(opts);
+}
+
+static options::PluginShared<MergeTreeFactory> _plugin("balanced", _parse);
+}
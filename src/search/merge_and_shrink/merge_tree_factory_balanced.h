@@ -0,0 +1,38 @@
+#ifndef MERGE_AND_SHRINK_MERGE_TREE_FACTORY_BALANCED_H
+#define MERGE_AND_SHRINK_MERGE_TREE_FACTORY_BALANCED_H
+
+#include "merge_tree_factory.h"
+
+#include "../variable_order_finder.h"
+
+namespace merge_and_shrink {
+struct MergeTreeNode;
+
+/*
+  Balanced merge trees take the transition systems in a variable order
+  and merge neighbors level by level: first the 1st with the 2nd, the 3rd
+  with the 4th, and so on, then the results in the same way. The merges
+  of a level are independent of each other (see
+  MergeTree::get_next_independent_merges).
+*/
+class MergeTreeFactoryBalanced : public MergeTreeFactory {
+    VariableOrderType variable_order_type;
+
+    MergeTreeNode *compute_balanced_tree(const std::vector<int> &ts_indices);
+protected:
+    virtual std::string name() const override;
+    virtual void dump_tree_specific_options() const override;
+public:
+    explicit MergeTreeFactoryBalanced(const options::Options &options);
+    virtual ~MergeTreeFactoryBalanced() override = default;
+    virtual std::unique_ptr<MergeTree> compute_merge_tree(
+        const TaskProxy &task_proxy) override;
+    virtual std::unique_ptr<MergeTree> compute_merge_tree(
+        const TaskProxy &task_proxy,
+        FactoredTransitionSystem &fts,
+        const std::vector<int> &indices_subset) override;
+    static void add_options_to_parser(options::OptionParser &parser);
+};
+}
+
+#endif
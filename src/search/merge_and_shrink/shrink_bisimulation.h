@@ -42,6 +42,9 @@ public:
         int index,
         int target,
         Verbosity verbosity) const override;
+    virtual bool can_shrink_in_parallel() const override {
+        return true;
+    }
 };
 }
 
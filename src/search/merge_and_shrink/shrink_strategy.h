@@ -43,6 +43,14 @@ public:
         int target,
         Verbosity verbosity) const = 0;
 
+    /*
+      Whether different transition systems may be shrunk at the same time
+      (in different threads) with the same result as one after the other.
+    */
+    virtual bool can_shrink_in_parallel() const {
+        return false;
+    }
+
     void dump_options() const;
     std::string get_name() const;
 };
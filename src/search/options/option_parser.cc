@@ -58,6 +58,8 @@ class PatternGenerator;
 
 namespace options {
 const string OptionParser::NONE = "<none>";
+vector<Heuristic *> *OptionParser::created_heuristics = nullptr;
+vector<Heuristic *> *OptionParser::looked_up_heuristics = nullptr;
 
 
 void OptionParser::error(string msg) {
@@ -374,9 +376,14 @@ SearchEngine *OptionParser::parse_cmd_line_aux(
 string OptionParser::usage(string progname) {
     string usage =
         "usage: \n" +
-        progname + " [OPTIONS] --search SEARCH < OUTPUT\n\n"
+        progname + " [OPTIONS] --search SEARCH < OUTPUT\n" +
+        progname + " --server OUTPUT [--socket PATH]\n" +
+        progname + " --convert-task BINARY_OUTPUT < OUTPUT\n\n"
         "* SEARCH (SearchEngine): configuration of the search algorithm\n"
-        "* OUTPUT (filename): preprocessor output\n\n"
+        "* OUTPUT (filename): preprocessor output, or a binary task\n"
+        "    written by --convert-task (see binary_task.h)\n"
+        "* PATH (filename): Unix socket on which the server listens.\n"
+        "    Without --socket, requests are read from stdin\n\n"
         "Options:\n"
         "--help [NAME]\n"
         "    Prints help for all heuristics, open lists, etc. called NAME.\n"
@@ -599,35 +606,41 @@ bool OptionParser::is_valid_option(const string &k) const {
 
 void OptionParser::document_values(string argument,
                                    ValueExplanations value_explanations) const {
-    DocStore::instance()->add_value_explanations(
-        parse_tree.begin()->value,
-        argument, value_explanations);
+    if (help_mode())
+        DocStore::instance()->add_value_explanations(
+            parse_tree.begin()->value,
+            argument, value_explanations);
 }
 
 void OptionParser::document_synopsis(string name, string note) const {
-    DocStore::instance()->set_synopsis(parse_tree.begin()->value,
-                                       name, note);
+    if (help_mode())
+        DocStore::instance()->set_synopsis(parse_tree.begin()->value,
+                                           name, note);
 }
 
 void OptionParser::document_property(string property, string note) const {
-    DocStore::instance()->add_property(parse_tree.begin()->value,
-                                       property, note);
+    if (help_mode())
+        DocStore::instance()->add_property(parse_tree.begin()->value,
+                                           property, note);
 }
 
 void OptionParser::document_language_support(string feature,
                                              string note) const {
-    DocStore::instance()->add_feature(parse_tree.begin()->value,
-                                      feature, note);
+    if (help_mode())
+        DocStore::instance()->add_feature(parse_tree.begin()->value,
+                                          feature, note);
 }
 
 void OptionParser::document_note(string name,
                                  string note, bool long_text) const {
-    DocStore::instance()->add_note(parse_tree.begin()->value,
-                                   name, note, long_text);
+    if (help_mode())
+        DocStore::instance()->add_note(parse_tree.begin()->value,
+                                       name, note, long_text);
 }
 
 void OptionParser::document_hide() const {
-    DocStore::instance()->hide(parse_tree.begin()->value);
+    if (help_mode())
+        DocStore::instance()->hide(parse_tree.begin()->value);
 }
 
 bool OptionParser::dry_run() const {
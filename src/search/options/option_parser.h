@@ -13,6 +13,7 @@
 #include <string>
 #include <vector>
 
+class Heuristic;
 class SearchEngine;
 
 namespace options {
@@ -34,6 +35,16 @@ public:
 
     static const std::string NONE;
 
+    /*
+      If set, the heuristics that parsing creates from the plugin registry
+      (including the ones that are then predefined) are appended to it, so
+      that their owner can delete them (see planner_server.cc).
+    */
+    static std::vector<Heuristic *> *created_heuristics;
+    // If set, the predefined heuristics that parsing looks up by name are
+    // appended to it, so that their owner knows which ones are used.
+    static std::vector<Heuristic *> *looked_up_heuristics;
+
     //this is where input from the commandline goes:
     static SearchEngine *parse_cmd_line(
         int argc, const char **argv, bool dr, bool is_unit_cost);
@@ -66,6 +77,10 @@ public:
 
     bool is_valid_option(const std::string &k) const;
 
+    /*
+      The documentation is only stored in help mode, so that heuristics can
+      be parsed concurrently (see ParallelHeuristicEvaluator).
+    */
     void document_values(std::string argument,
                          ValueExplanations value_explanations) const;
     void document_synopsis(std::string name, std::string note) const;
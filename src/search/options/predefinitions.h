@@ -31,6 +31,14 @@ public:
         return predefined[k];
     }
 
+    bool contains_object(const T &obj) const {
+        for (const auto &entry : predefined) {
+            if (entry.second == obj)
+                return true;
+        }
+        return false;
+    }
+
 private:
     Predefinitions<T>() = default;
     std::map<std::string, T> predefined;
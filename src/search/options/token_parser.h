@@ -128,6 +128,19 @@ static T *lookup_in_predefinitions(OptionParser &p, bool &found) {
     return 0;
 }
 
+// The dry run creates no heuristics, so null results are not recorded.
+inline Heuristic *record_created_heuristic(Heuristic *heuristic) {
+    if (heuristic && OptionParser::created_heuristics)
+        OptionParser::created_heuristics->push_back(heuristic);
+    return heuristic;
+}
+
+inline Heuristic *record_looked_up_heuristic(Heuristic *heuristic) {
+    if (heuristic && OptionParser::looked_up_heuristics)
+        OptionParser::looked_up_heuristics->push_back(heuristic);
+    return heuristic;
+}
+
 template<typename T>
 static std::shared_ptr<T> lookup_in_predefinitions_shared(OptionParser &p, bool &found) {
     using TPtr = std::shared_ptr<T>;
@@ -149,18 +162,27 @@ template<>
 inline ScalarEvaluator *TokenParser<ScalarEvaluator *>::parse(OptionParser &p) {
     ParseTree::iterator pt = p.get_parse_tree()->begin();
     if (Predefinitions<Heuristic *>::instance()->contains(pt->value)) {
-        return (ScalarEvaluator *)
-               Predefinitions<Heuristic *>::instance()->get(pt->value);
+        return (ScalarEvaluator *) record_looked_up_heuristic(
+            Predefinitions<Heuristic *>::instance()->get(pt->value));
     } else if (Registry<ScalarEvaluator *>::instance()->contains(pt->value)) {
         return Registry<ScalarEvaluator *>::instance()->get(pt->value) (p);
     } else if (Registry<Heuristic *>::instance()->contains(pt->value)) {
-        return (ScalarEvaluator *)
-               Registry<Heuristic *>::instance()->get(pt->value) (p);
+        return (ScalarEvaluator *) record_created_heuristic(
+            Registry<Heuristic *>::instance()->get(pt->value) (p));
     }
     p.error("ScalarEvaluator " + pt->value + " not found");
     return 0;
 }
 
+template<>
+inline Heuristic *TokenParser<Heuristic *>::parse(OptionParser &p) {
+    bool predefined;
+    Heuristic *result = lookup_in_predefinitions<Heuristic>(p, predefined);
+    if (predefined)
+        return record_looked_up_heuristic(result);
+    return record_created_heuristic(lookup_in_registry<Heuristic>(p));
+}
+
 // TODO: The following method can go away once we use shared pointers for all plugins.
 template<typename T>
 inline T *TokenParser<T *>::parse(OptionParser &p) {
@@ -0,0 +1,101 @@
+#include "parallel_heuristic_evaluator.h"
+
+#include "evaluation_result.h"
+#include "global_state.h"
+#include "heuristic.h"
+#include "option_parser.h"
+#include "search_statistics.h"
+
+#include <cassert>
+
+using namespace std;
+
+ParallelHeuristicEvaluator::ParallelHeuristicEvaluator(
+    const vector<Heuristic *> &heuristics, int num_threads)
+    : heuristics(heuristics),
+      thread_pool(num_threads) {
+    assert(can_evaluate_in_parallel(heuristics));
+    int num_heuristics = heuristics.size();
+    for (Heuristic *heuristic : heuristics) {
+        instances.emplace_back(num_threads, heuristic);
+    }
+    thread_instances.resize(num_heuristics * num_threads);
+    /*
+      The calling thread (thread 0) evaluates the original heuristics. The
+      copies for the other threads are built in parallel. The original
+      heuristics have been built from the same configurations already, so
+      shared data they compute on construction (e.g., the causal graph) is
+      only read.
+    */
+    thread_pool.run(num_threads - 1, [&](int task, int) {
+                        int thread = task + 1;
+                        for (int i = 0; i < num_heuristics; ++i) {
+                            Heuristic *heuristic = heuristics[i];
+                            if (heuristic->get_parallel_evaluation() !=
+                                Heuristic::ParallelEvaluation::PER_THREAD)
+                                continue;
+                            OptionParser parser(
+                                heuristic->get_description(), false);
+                            unique_ptr<Heuristic> &copy =
+                                thread_instances[i * num_threads + thread];
+                            copy.reset(parser.start_parsing<Heuristic *>());
+                            instances[i][thread] = copy.get();
+                        }
+                    });
+}
+
+ParallelHeuristicEvaluator::~ParallelHeuristicEvaluator() {
+}
+
+bool ParallelHeuristicEvaluator::can_evaluate_in_parallel(
+    const vector<Heuristic *> &heuristics) {
+    for (Heuristic *heuristic : heuristics) {
+        if (heuristic->get_parallel_evaluation() ==
+            Heuristic::ParallelEvaluation::SERIAL)
+            return false;
+    }
+    return true;
+}
+
+int ParallelHeuristicEvaluator::get_num_threads() const {
+    return thread_pool.get_num_threads();
+}
+
+vector<HeuristicCache> ParallelHeuristicEvaluator::evaluate(
+    const vector<GlobalState> &states, SearchStatistics &statistics) {
+    int num_heuristics = heuristics.size();
+    // Heuristic values that are cached already are not computed again,
+    // so that they are handled (and counted) as in serial evaluation.
+    vector<vector<EvaluationResult>> results(states.size());
+    vector<vector<bool>> needs_result(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        results[i].resize(num_heuristics);
+        needs_result[i].resize(num_heuristics);
+        for (int j = 0; j < num_heuristics; ++j) {
+            needs_result[i][j] = !heuristics[j]->is_result_cached(states[i]);
+        }
+    }
+
+    thread_pool.run(states.size(), [&](int task, int thread) {
+                        for (int j = 0; j < num_heuristics; ++j) {
+                            if (needs_result[task][j]) {
+                                results[task][j] = instances[j][thread]->
+                                    compute_result_in_parallel(states[task]);
+                            }
+                        }
+                    });
+
+    vector<HeuristicCache> caches;
+    caches.reserve(states.size());
+    for (size_t i = 0; i < states.size(); ++i) {
+        caches.emplace_back(states[i]);
+        for (int j = 0; j < num_heuristics; ++j) {
+            if (needs_result[i][j]) {
+                heuristics[j]->store_result(states[i], results[i][j]);
+                caches.back()[heuristics[j]] = results[i][j];
+                statistics.inc_evaluations();
+            }
+        }
+    }
+    return caches;
+}
@@ -0,0 +1,45 @@
+#ifndef PARALLEL_HEURISTIC_EVALUATOR_H
+#define PARALLEL_HEURISTIC_EVALUATOR_H
+
+#include "heuristic_cache.h"
+
+#include "utils/thread_pool.h"
+
+#include <memory>
+#include <vector>
+
+class GlobalState;
+class Heuristic;
+class SearchStatistics;
+
+/*
+  Evaluates the heuristics of a search for a batch of states with several
+  threads. Depending on Heuristic::get_parallel_evaluation(), the threads
+  share a heuristic or use their own instances of it.
+
+  The results are stored in the caches of the heuristics and returned as
+  one HeuristicCache per state. Searches create their evaluation contexts
+  from these caches in their usual order, so the search behaves exactly
+  like with serial evaluation.
+*/
+class ParallelHeuristicEvaluator {
+    std::vector<Heuristic *> heuristics;
+    // instances[i][thread] evaluates heuristics[i] in the given thread
+    std::vector<std::vector<Heuristic *>> instances;
+    // Copies for PER_THREAD heuristics, at [i * num_threads + thread]
+    std::vector<std::unique_ptr<Heuristic>> thread_instances;
+    utils::ThreadPool thread_pool;
+public:
+    ParallelHeuristicEvaluator(
+        const std::vector<Heuristic *> &heuristics, int num_threads);
+    ~ParallelHeuristicEvaluator();
+
+    static bool can_evaluate_in_parallel(
+        const std::vector<Heuristic *> &heuristics);
+
+    int get_num_threads() const;
+    std::vector<HeuristicCache> evaluate(
+        const std::vector<GlobalState> &states, SearchStatistics &statistics);
+};
+
+#endif
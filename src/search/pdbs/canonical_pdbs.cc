@@ -2,11 +2,13 @@
 
 #include "dominance_pruning.h"
 #include "pattern_database.h"
+#include "state_block.h"
 
 #include <algorithm>
 #include <cassert>
 #include <iostream>
 #include <limits>
+#include <unordered_map>
 
 using namespace std;
 
@@ -21,6 +23,18 @@ CanonicalPDBs::CanonicalPDBs(
         max_additive_subsets = prune_dominated_subsets(
             *pattern_databases, *max_additive_subsets);
     }
+
+    unordered_map<PatternDatabase *, int> pdb_indices;
+    for (const PDBCollection &subset : *max_additive_subsets) {
+        vector<int> indices;
+        for (const shared_ptr<PatternDatabase> &pdb : subset) {
+            auto result = pdb_indices.emplace(pdb.get(), pdbs.size());
+            if (result.second)
+                pdbs.push_back(pdb);
+            indices.push_back(result.first->second);
+        }
+        subset_pdb_indices.push_back(move(indices));
+    }
 }
 
 int CanonicalPDBs::get_value(const State &state) const {
@@ -41,4 +55,50 @@ int CanonicalPDBs::get_value(const State &state) const {
     }
     return max_h;
 }
+
+vector<int> CanonicalPDBs::get_values(const vector<State> &states) const {
+    const int block_size = StateBlock::MAX_SIZE;
+    int num_states = states.size();
+    vector<int> h_values(num_states);
+    StateBlock block(pdbs);
+    // pdb_values[i * block_size + j] is the h-value of pdbs[i] for state j
+    vector<int> pdb_values(pdbs.size() * block_size);
+    bool is_dead_end[block_size];
+    int subset_h[block_size];
+    for (int begin = 0; begin < num_states; begin += block_size) {
+        int size = min(block_size, num_states - begin);
+        block.load(states, begin, size);
+        fill(is_dead_end, is_dead_end + size, false);
+        for (size_t i = 0; i < pdbs.size(); ++i) {
+            int *values = &pdb_values[i * block_size];
+            pdbs[i]->get_values(block, values);
+            // Dead ends are marked and contribute 0 to the sums below.
+            for (int j = 0; j < size; ++j) {
+                bool infinite = values[j] == numeric_limits<int>::max();
+                is_dead_end[j] |= infinite;
+                values[j] = infinite ? 0 : values[j];
+            }
+        }
+
+        int *block_h = &h_values[begin];
+        fill(block_h, block_h + size, 0);
+        for (const vector<int> &subset : subset_pdb_indices) {
+            fill(subset_h, subset_h + size, 0);
+            for (int pdb_index : subset) {
+                const int *values = &pdb_values[pdb_index * block_size];
+                for (int j = 0; j < size; ++j) {
+                    subset_h[j] += values[j];
+                }
+            }
+            for (int j = 0; j < size; ++j) {
+                block_h[j] = max(block_h[j], subset_h[j]);
+            }
+        }
+        for (int j = 0; j < size; ++j) {
+            if (is_dead_end[j])
+                block_h[j] = numeric_limits<int>::max();
+        }
+    }
+    return h_values;
+}
 }
@@ -4,6 +4,7 @@
 #include "types.h"
 
 #include <memory>
+#include <vector>
 
 class State;
 
@@ -11,6 +12,11 @@ namespace pdbs {
 class CanonicalPDBs {
     std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
 
+    // The PDBs occurring in max_additive_subsets, each listed once
+    PDBCollection pdbs;
+    // The subsets as indices into pdbs
+    std::vector<std::vector<int>> subset_pdb_indices;
+
 public:
     CanonicalPDBs(const std::shared_ptr<PDBCollection> &pattern_databases,
                   const std::shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets,
@@ -18,6 +24,13 @@ public:
     ~CanonicalPDBs() = default;
 
     int get_value(const State &state) const;
+    /*
+      Returns the h-values of all given states. The states are evaluated
+      in blocks, every PDB is looked up once per state and the lookups
+      for a block run over the states in structure-of-arrays form (see
+      StateBlock).
+    */
+    std::vector<int> get_values(const std::vector<State> &states) const;
 };
 }
 
@@ -0,0 +1,177 @@
+#include "distance_table.h"
+
+#include "../option_parser.h"
+
+#include <limits>
+
+using namespace std;
+
+namespace pdbs {
+static int get_max_code(DistanceStorage storage) {
+    switch (storage) {
+    case DistanceStorage::INT32:
+        return numeric_limits<int>::max();
+    case DistanceStorage::UINT16:
+        return UINT16_MAX;
+    case DistanceStorage::UINT8:
+        return UINT8_MAX;
+    case DistanceStorage::NIBBLE:
+        return 0xf;
+    }
+    assert(false);
+    return 0;
+}
+
+static size_t get_num_data_bytes(DistanceStorage storage, size_t num_entries) {
+    switch (storage) {
+    case DistanceStorage::INT32:
+        return 4 * num_entries;
+    case DistanceStorage::UINT16:
+        return 2 * num_entries;
+    case DistanceStorage::UINT8:
+        return num_entries;
+    case DistanceStorage::NIBBLE:
+        return (num_entries + 1) / 2;
+    }
+    assert(false);
+    return 0;
+}
+
+DistanceTable::DistanceTable()
+    : storage(DistanceStorage::INT32),
+      num_entries(0),
+      data(nullptr) {
+}
+
+DistanceTable::DistanceTable(
+    const vector<int> &distances, DistanceStorage storage)
+    : storage(storage),
+      num_entries(distances.size()) {
+    size_t num_bytes = pdbs::get_num_data_bytes(storage, num_entries);
+    unsigned char *buffer = new unsigned char[num_bytes]();
+    memory = shared_ptr<const unsigned char>(
+        buffer, default_delete<const unsigned char[]>());
+    data = buffer;
+
+    int max_code = get_max_code(storage);
+    for (size_t index = 0; index < num_entries; ++index) {
+        int code = distances[index];
+        assert(code >= 0);
+        if (storage != DistanceStorage::INT32) {
+            if (code == numeric_limits<int>::max()) {
+                code = max_code - 1;
+            } else if (code >= max_code - 1) {
+                overflow[index] = code;
+                code = max_code;
+            }
+        }
+        switch (storage) {
+        case DistanceStorage::INT32: {
+            int32_t value = code;
+            memcpy(buffer + 4 * index, &value, 4);
+            break;
+        }
+        case DistanceStorage::UINT16: {
+            uint16_t value = code;
+            memcpy(buffer + 2 * index, &value, 2);
+            break;
+        }
+        case DistanceStorage::UINT8:
+            buffer[index] = code;
+            break;
+        case DistanceStorage::NIBBLE:
+            buffer[index / 2] |= code << (4 * (index % 2));
+            break;
+        }
+    }
+}
+
+DistanceTable::DistanceTable(
+    DistanceStorage storage, size_t num_entries,
+    const shared_ptr<const unsigned char> &memory, const unsigned char *data,
+    unordered_map<size_t, int> &&overflow)
+    : storage(storage),
+      num_entries(num_entries),
+      memory(memory),
+      data(data),
+      overflow(move(overflow)) {
+}
+
+int DistanceTable::get_overflow(size_t index) const {
+    auto it = overflow.find(index);
+    assert(it != overflow.end());
+    return it->second;
+}
+
+void DistanceTable::get_values(
+    const size_t *indices, int num_indices, int *values) const {
+    switch (storage) {
+    case DistanceStorage::INT32:
+        for (int i = 0; i < num_indices; ++i) {
+            int32_t value;
+            memcpy(&value, data + 4 * indices[i], 4);
+            values[i] = value;
+        }
+        // No overflow table
+        return;
+    case DistanceStorage::UINT16:
+        for (int i = 0; i < num_indices; ++i) {
+            uint16_t code;
+            memcpy(&code, data + 2 * indices[i], 2);
+            values[i] = code;
+        }
+        break;
+    case DistanceStorage::UINT8:
+        for (int i = 0; i < num_indices; ++i) {
+            values[i] = data[indices[i]];
+        }
+        break;
+    case DistanceStorage::NIBBLE:
+        for (int i = 0; i < num_indices; ++i) {
+            size_t index = indices[i];
+            values[i] = (data[index / 2] >> (4 * (index % 2))) & 0xf;
+        }
+        break;
+    }
+    int max_code = get_max_code(storage);
+    for (int i = 0; i < num_indices; ++i) {
+        values[i] = decode(values[i], max_code, indices[i]);
+    }
+}
+
+size_t DistanceTable::get_num_data_bytes() const {
+    return pdbs::get_num_data_bytes(storage, num_entries);
+}
+
+size_t DistanceTable::estimate_num_bytes() const {
+    // Key, value and about two pointers per entry of the overflow table
+    size_t bytes_per_overflow_entry =
+        sizeof(pair<const size_t, int>) + 2 * sizeof(void *);
+    return get_num_data_bytes() + overflow.size() * bytes_per_overflow_entry;
+}
+
+void add_distance_storage_option_to_parser(options::OptionParser &parser) {
+    vector<string> storages;
+    vector<string> storages_doc;
+    storages.push_back("INT32");
+    storages_doc.push_back("4 bytes per abstract state");
+    storages.push_back("UINT16");
+    storages_doc.push_back(
+        "2 bytes per abstract state, h-values from 65534 in an overflow "
+        "table");
+    storages.push_back("UINT8");
+    storages_doc.push_back(
+        "1 byte per abstract state, h-values from 254 in an overflow table");
+    storages.push_back("NIBBLE");
+    storages_doc.push_back(
+        "half a byte per abstract state, h-values from 14 in an overflow "
+        "table");
+    parser.add_enum_option(
+        "storage",
+        storages,
+        "storage of the h-values of the PDBs. The overflow table pays off "
+        "when most h-values fit into the storage.",
+        "INT32",
+        storages_doc);
+}
+}
@@ -0,0 +1,120 @@
+#ifndef PDBS_DISTANCE_TABLE_H
+#define PDBS_DISTANCE_TABLE_H
+
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace options {
+class OptionParser;
+}
+
+namespace pdbs {
+enum class DistanceStorage {
+    INT32,
+    UINT16,
+    UINT8,
+    NIBBLE
+};
+
+/*
+  The h-values of the abstract states of a PDB, stored with 32, 16, 8 or
+  4 bits per abstract state (NIBBLE packs two states into a byte). With
+  less than 32 bits, the two largest codes of the storage are reserved:
+  the second largest stands for dead ends and the largest for h-values
+  that do not fit, which are kept in an overflow table.
+
+  The encoded entries are either owned by the table or live in a
+  memory-mapped PDB cache file (see PDBCache). They are never modified
+  and shared between copies of the table.
+*/
+class DistanceTable {
+    DistanceStorage storage;
+    std::size_t num_entries;
+    std::shared_ptr<const unsigned char> memory;
+    const unsigned char *data;
+    std::unordered_map<std::size_t, int> overflow;
+
+    int get_overflow(std::size_t index) const;
+
+    int decode(int code, int max_code, std::size_t index) const {
+        if (code < max_code - 1)
+            return code;
+        else if (code == max_code - 1)
+            return std::numeric_limits<int>::max();
+        return get_overflow(index);
+    }
+public:
+    DistanceTable();
+    DistanceTable(const std::vector<int> &distances, DistanceStorage storage);
+    /*
+      Uses encoded entries that start at data, which must lie in memory
+      and stay valid as long as memory is alive.
+    */
+    DistanceTable(DistanceStorage storage, std::size_t num_entries,
+                  const std::shared_ptr<const unsigned char> &memory,
+                  const unsigned char *data,
+                  std::unordered_map<std::size_t, int> &&overflow);
+
+    int get(std::size_t index) const;
+    // values[i] = get(indices[i]) for i < num_indices
+    void get_values(const std::size_t *indices, int num_indices,
+                    int *values) const;
+
+    std::size_t size() const {
+        return num_entries;
+    }
+
+    DistanceStorage get_storage() const {
+        return storage;
+    }
+
+    const unsigned char *get_data() const {
+        return data;
+    }
+
+    std::size_t get_num_data_bytes() const;
+
+    const std::unordered_map<std::size_t, int> &get_overflow() const {
+        return overflow;
+    }
+
+    // Memory used by the encoded entries and the overflow table
+    std::size_t estimate_num_bytes() const;
+};
+
+inline int DistanceTable::get(std::size_t index) const {
+    assert(index < num_entries);
+    switch (storage) {
+    case DistanceStorage::INT32: {
+        int32_t value;
+        memcpy(&value, data + 4 * index, 4);
+        return value;
+    }
+    case DistanceStorage::UINT16: {
+        uint16_t code;
+        memcpy(&code, data + 2 * index, 2);
+        return decode(code, UINT16_MAX, index);
+    }
+    case DistanceStorage::UINT8: {
+        uint8_t code = data[index];
+        return decode(code, UINT8_MAX, index);
+    }
+    case DistanceStorage::NIBBLE: {
+        uint8_t code = (data[index / 2] >> (4 * (index % 2))) & 0xf;
+        return decode(code, 0xf, index);
+    }
+    }
+    assert(false);
+    return 0;
+}
+
+void add_distance_storage_option_to_parser(options::OptionParser &parser);
+}
+
+#endif
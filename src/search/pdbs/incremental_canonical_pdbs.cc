@@ -46,7 +46,7 @@ void IncrementalCanonicalPDBs::recompute_max_additive_subsets() {
 }
 
 MaxAdditivePDBSubsets IncrementalCanonicalPDBs::get_max_additive_subsets(
-    const Pattern &new_pattern) {
+    const Pattern &new_pattern) const {
     return pdbs::compute_max_additive_subsets_with_pattern(
         *max_additive_subsets, new_pattern, are_additive);
 }
@@ -56,6 +56,12 @@ int IncrementalCanonicalPDBs::get_value(const State &state) const {
     return canonical_pdbs.get_value(state);
 }
 
+vector<int> IncrementalCanonicalPDBs::get_values(
+    const vector<State> &states) const {
+    CanonicalPDBs canonical_pdbs(pattern_databases, max_additive_subsets, false);
+    return canonical_pdbs.get_values(states);
+}
+
 bool IncrementalCanonicalPDBs::is_dead_end(const State &state) const {
     for (const shared_ptr<PatternDatabase> &pdb : *pattern_databases)
         if (pdb->get_value(state) == numeric_limits<int>::max())
@@ -8,6 +8,7 @@
 #include "../task_proxy.h"
 
 #include <memory>
+#include <vector>
 
 namespace pdbs {
 class IncrementalCanonicalPDBs {
@@ -37,9 +38,12 @@ public:
 
     /* Returns a set of subsets that would be additive to the new pattern.
        Detailed documentation in max_additive_pdb_sets.h */
-    MaxAdditivePDBSubsets get_max_additive_subsets(const Pattern &new_pattern);
+    MaxAdditivePDBSubsets get_max_additive_subsets(
+        const Pattern &new_pattern) const;
 
     int get_value(const State &state) const;
+    // Batch version of get_value (see CanonicalPDBs::get_values)
+    std::vector<int> get_values(const std::vector<State> &states) const;
 
     /*
       The following method offers a quick dead-end check for the sampling
@@ -0,0 +1,140 @@
+#include "parallel_pdb_construction.h"
+
+#include "pattern_database.h"
+#include "pdb_cache.h"
+
+#include "../option_parser.h"
+#include "../task_proxy.h"
+
+#include "../utils/memory.h"
+#include "../utils/thread_pool.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <limits>
+#include <mutex>
+#include <numeric>
+
+using namespace std;
+
+namespace pdbs {
+// Distance table and (on average) one entry in the Dijkstra queue
+static const size_t ESTIMATED_BYTES_PER_ABSTRACT_STATE = 16;
+
+static size_t estimate_construction_bytes(
+    const TaskProxy &task_proxy, const Pattern &pattern) {
+    VariablesProxy variables = task_proxy.get_variables();
+    size_t bytes = ESTIMATED_BYTES_PER_ABSTRACT_STATE;
+    for (int var_id : pattern) {
+        size_t domain_size = variables[var_id].get_domain_size();
+        if (bytes > numeric_limits<size_t>::max() / domain_size)
+            return numeric_limits<size_t>::max();
+        bytes *= domain_size;
+    }
+    return bytes;
+}
+
+ParallelPDBConstruction::ParallelPDBConstruction()
+    : num_threads(1),
+      memory_budget(0),
+      storage(DistanceStorage::INT32) {
+}
+
+ParallelPDBConstruction::ParallelPDBConstruction(const Options &opts)
+    : num_threads(opts.get<int>("construction_threads")),
+      memory_budget(static_cast<size_t>(
+                        opts.get<int>("construction_memory")) << 20),
+      storage(DistanceStorage(opts.get_enum("storage"))),
+      cache_directory(opts.contains("cache_directory") ?
+                      opts.get<string>("cache_directory") : "") {
+    if (num_threads == 0)
+        num_threads = utils::get_hardware_concurrency();
+}
+
+shared_ptr<PDBCollection> ParallelPDBConstruction::build_pdbs(
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    const OperatorCostFunction &get_operator_costs) const {
+    int num_patterns = patterns.size();
+    shared_ptr<PDBCollection> pdbs = make_shared<PDBCollection>(num_patterns);
+    unique_ptr<PDBCache> cache;
+    if (!cache_directory.empty())
+        cache = utils::make_unique_ptr<PDBCache>(cache_directory, task_proxy);
+    auto build_pdb = [&](int i) {
+            (*pdbs)[i] = make_shared<PatternDatabase>(
+                task_proxy, patterns[i], false,
+                get_operator_costs ? get_operator_costs(i) : vector<int>(),
+                storage, cache.get());
+        };
+
+    int used_threads = min(num_threads, num_patterns);
+    if (used_threads <= 1) {
+        for (int i = 0; i < num_patterns; ++i) {
+            build_pdb(i);
+        }
+        return pdbs;
+    }
+
+    vector<size_t> estimated_bytes;
+    estimated_bytes.reserve(num_patterns);
+    for (const Pattern &pattern : patterns) {
+        estimated_bytes.push_back(
+            estimate_construction_bytes(task_proxy, pattern));
+    }
+    vector<int> order(num_patterns);
+    iota(order.begin(), order.end(), 0);
+    stable_sort(order.begin(), order.end(), [&](int i, int j) {
+                    return estimated_bytes[i] > estimated_bytes[j];
+                });
+
+    mutex budget_mutex;
+    condition_variable budget_released;
+    size_t bytes_in_use = 0;
+    utils::ThreadPool pool(used_threads);
+    pool.run(num_patterns, [&](int task, int) {
+                 int i = order[task];
+                 size_t bytes = estimated_bytes[i];
+                 if (memory_budget) {
+                     unique_lock<mutex> lock(budget_mutex);
+                     budget_released.wait(lock, [&]() {
+                                              return bytes_in_use == 0 ||
+                                              bytes <= memory_budget - bytes_in_use;
+                                          });
+                     bytes_in_use += bytes;
+                 }
+                 build_pdb(i);
+                 if (memory_budget) {
+                     {
+                         lock_guard<mutex> lock(budget_mutex);
+                         bytes_in_use -= bytes;
+                     }
+                     budget_released.notify_all();
+                 }
+             });
+    return pdbs;
+}
+
+void ParallelPDBConstruction::add_options_to_parser(OptionParser &parser) {
+    parser.add_option<int>(
+        "construction_threads",
+        "Number of threads that build the PDBs of the pattern collection "
+        "(0: one per core). The PDBs are the same as with serial "
+        "construction.",
+        "1",
+        Bounds("0", "infinity"));
+    parser.add_option<int>(
+        "construction_memory",
+        "Memory budget in MiB for the PDBs that are built at the same "
+        "time, estimated from their numbers of abstract states "
+        "(0: no limit). A PDB that exceeds the budget on its own is built "
+        "alone.",
+        "1024",
+        Bounds("0", "infinity"));
+    add_distance_storage_option_to_parser(parser);
+    parser.add_option<string>(
+        "cache_directory",
+        "Directory in which the h-values of the PDBs are stored, so that "
+        "later runs on the same task load them instead of building the "
+        "PDBs again. Not used if omitted.",
+        OptionParser::NONE);
+}
+}
@@ -0,0 +1,73 @@
+#ifndef PDBS_PARALLEL_PDB_CONSTRUCTION_H
+#define PDBS_PARALLEL_PDB_CONSTRUCTION_H
+
+#include "distance_table.h"
+#include "types.h"
+
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class TaskProxy;
+
+namespace options {
+class OptionParser;
+class Options;
+}
+
+namespace pdbs {
+/*
+  Returns the operator costs for the pattern with the given index (see
+  PatternDatabase). It is called right before the PDB is built, so that
+  only the costs of the PDBs under construction are stored.
+*/
+using OperatorCostFunction = std::function<std::vector<int>(int)>;
+
+/*
+  Builds the PDBs of a pattern collection on a thread pool. Given their
+  operator costs, the PDBs are independent, so they are built
+  concurrently from the same task, which is only read.
+
+  Every construction is estimated to need a fixed number of bytes per
+  abstract state (distance table and Dijkstra queue). The largest PDBs
+  are started first, so that the threads finish at about the same time.
+  A PDB is only started while the estimates of all PDBs under
+  construction fit into the memory budget. A PDB that does not fit on its
+  own is built alone.
+
+  The PDBs are the same as when they are built one after another.
+
+  The options also select how the PDBs store their h-values and the
+  directory of the PDB cache (see PDBCache), if any.
+*/
+class ParallelPDBConstruction {
+    int num_threads;
+    // In bytes, 0 for no limit
+    std::size_t memory_budget;
+    DistanceStorage storage;
+    // Empty if the cache is not used
+    std::string cache_directory;
+public:
+    // Serial construction
+    ParallelPDBConstruction();
+    explicit ParallelPDBConstruction(const options::Options &opts);
+
+    int get_num_threads() const {
+        return num_threads;
+    }
+
+    /*
+      Without get_operator_costs, the PDBs use the costs of the task. The
+      PDBs are returned in the order of the patterns.
+    */
+    std::shared_ptr<PDBCollection> build_pdbs(
+        const TaskProxy &task_proxy, const PatternCollection &patterns,
+        const OperatorCostFunction &get_operator_costs = nullptr) const;
+
+    static void add_options_to_parser(options::OptionParser &parser);
+};
+}
+
+#endif
@@ -30,7 +30,8 @@ PatternCollectionGeneratorGenetic::PatternCollectionGeneratorGenetic(
       num_episodes(opts.get<int>("num_episodes")),
       mutation_probability(opts.get<double>("mutation_probability")),
       disjoint_patterns(opts.get<bool>("disjoint")),
-      rng(utils::parse_rng_from_options(opts)) {
+      rng(utils::parse_rng_from_options(opts)),
+      pdb_construction(opts) {
 }
 
 void PatternCollectionGeneratorGenetic::select(
@@ -194,7 +195,8 @@ void PatternCollectionGeneratorGenetic::evaluate(vector<double> &fitness_values)
         } else {
             /* Generate the pattern collection heuristic and get its fitness
                value. */
-            ZeroOnePDBs zero_one_pdbs(task_proxy, *pattern_collection);
+            ZeroOnePDBs zero_one_pdbs(
+                task_proxy, *pattern_collection, pdb_construction);
             fitness = zero_one_pdbs.compute_approx_mean_finite_h();
             // Update the best heuristic found so far.
             if (fitness > best_fitness) {
@@ -365,6 +367,7 @@ static shared_ptr<PatternCollectionGenerator> _parse(OptionParser &parser) {
         "consider a pattern collection invalid (giving it very low "
         "fitness) if its patterns are not disjoint",
         "false");
+    ParallelPDBConstruction::add_options_to_parser(parser);
 
     utils::add_rng_options(parser);
 
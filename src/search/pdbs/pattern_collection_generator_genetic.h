@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_COLLECTION_GENERATOR_GENETIC_H
 #define PDBS_PATTERN_COLLECTION_GENERATOR_GENETIC_H
 
+#include "parallel_pdb_construction.h"
 #include "pattern_generator.h"
 #include "types.h"
 
@@ -34,6 +35,8 @@ class PatternCollectionGeneratorGenetic : public PatternCollectionGenerator {
        or not. */
     const bool disjoint_patterns;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
+    // Builds the PDBs of every evaluated pattern collection
+    const ParallelPDBConstruction pdb_construction;
 
     std::shared_ptr<AbstractTask> task;
 
@@ -18,9 +18,11 @@
 #include "../utils/memory.h"
 #include "../utils/rng.h"
 #include "../utils/rng_options.h"
+#include "../utils/thread_pool.h"
 #include "../utils/timer.h"
 
 #include <algorithm>
+#include <atomic>
 #include <cassert>
 #include <exception>
 #include <iostream>
@@ -38,6 +40,7 @@ PatternCollectionGeneratorHillclimbing::PatternCollectionGeneratorHillclimbing(c
       min_improvement(opts.get<int>("min_improvement")),
       max_time(opts.get<double>("max_time")),
       rng(utils::parse_rng_from_options(opts)),
+      pdb_construction(opts),
       num_rejected(0),
       hill_climbing_timer(0) {
 }
@@ -50,7 +53,7 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
     const CausalGraph &causal_graph = task_proxy.get_causal_graph();
     const Pattern &pattern = pdb.get_pattern();
     int pdb_size = pdb.get_size();
-    int max_pdb_size = 0;
+    PatternCollection new_patterns;
     for (int pattern_var : pattern) {
         /* Only consider variables used in preconditions for current
            variable from pattern. It would also make sense to consider
@@ -77,16 +80,21 @@ int PatternCollectionGeneratorHillclimbing::generate_candidate_pdbs(
                       surpass the size limit.
                     */
                     generated_patterns.insert(new_pattern);
-                    candidate_pdbs.push_back(
-                        make_shared<PatternDatabase>(task_proxy, new_pattern));
-                    max_pdb_size = max(max_pdb_size,
-                                       candidate_pdbs.back()->get_size());
+                    new_patterns.push_back(move(new_pattern));
                 }
             } else {
                 ++num_rejected;
             }
         }
     }
+
+    shared_ptr<PDBCollection> new_pdbs =
+        pdb_construction.build_pdbs(task_proxy, new_patterns);
+    int max_pdb_size = 0;
+    for (const shared_ptr<PatternDatabase> &new_pdb : *new_pdbs) {
+        candidate_pdbs.push_back(new_pdb);
+        max_pdb_size = max(max_pdb_size, new_pdb->get_size());
+    }
     return max_pdb_size;
 }
 
@@ -122,44 +130,71 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
     int improvement = 0;
     int best_pdb_index = -1;
 
-    // Iterate over all candidates and search for the best improving pattern/pdb
+    /*
+      If a candidate's size added to the current collection's size exceeds
+      the maximum collection size, then forget the pdb.
+    */
+    vector<int> candidate_indices;
     for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
-        if (hill_climbing_timer->is_expired())
-            throw HillClimbingTimeout();
-
         const shared_ptr<PatternDatabase> &pdb = candidate_pdbs[i];
         if (!pdb) {
             /* candidate pattern is too large or has already been added to
                the canonical heuristic. */
             continue;
         }
-        /*
-          If a candidate's size added to the current collection's size exceeds
-          the maximum collection size, then forget the pdb.
-        */
         int combined_size = current_pdbs->get_size() + pdb->get_size();
         if (combined_size > collection_max_size) {
             candidate_pdbs[i] = nullptr;
             continue;
         }
+        candidate_indices.push_back(i);
+    }
+    // Evaluate the largest PDBs first to balance the load of the threads.
+    stable_sort(candidate_indices.begin(), candidate_indices.end(),
+                [&](int i, int j) {
+                    return candidate_pdbs[i]->get_size() >
+                    candidate_pdbs[j]->get_size();
+                });
 
-        /*
-          Calculate the "counting approximation" for all sample states: count
-          the number of samples for which the current pattern collection
-          heuristic would be improved if the new pattern was included into it.
-        */
-        /*
-          TODO: The original implementation by Haslum et al. uses m/t as a
-          statistical confidence interval to stop the A*-search (which they use,
-          see above) earlier.
-        */
-        int count = 0;
-        MaxAdditivePDBSubsets max_additive_subsets =
-            current_pdbs->get_max_additive_subsets(pdb->get_pattern());
-        for (State &sample : samples) {
-            if (is_heuristic_improved(*pdb, sample, max_additive_subsets))
-                ++count;
-        }
+    // h-values of the current collection, the same for all candidates
+    vector<int> h_collection = current_pdbs->get_values(samples);
+
+    /*
+      Calculate the "counting approximation" for all sample states: count
+      the number of samples for which the current pattern collection
+      heuristic would be improved if the new pattern was included into it.
+    */
+    /*
+      TODO: The original implementation by Haslum et al. uses m/t as a
+      statistical confidence interval to stop the A*-search (which they use,
+      see above) earlier.
+    */
+    vector<int> counts(candidate_pdbs.size(), 0);
+    atomic<bool> timeout(false);
+    evaluation_pool->run(
+        candidate_indices.size(), [&](int task, int) {
+            if (timeout || hill_climbing_timer->is_expired()) {
+                timeout = true;
+                return;
+            }
+            int i = candidate_indices[task];
+            const PatternDatabase &pdb = *candidate_pdbs[i];
+            MaxAdditivePDBSubsets max_additive_subsets =
+                current_pdbs->get_max_additive_subsets(pdb.get_pattern());
+            int count = 0;
+            for (size_t j = 0; j < samples.size(); ++j) {
+                if (is_heuristic_improved(pdb, samples[j], h_collection[j],
+                                          max_additive_subsets))
+                    ++count;
+            }
+            counts[i] = count;
+        });
+    if (timeout)
+        throw HillClimbingTimeout();
+
+    // Select the best pattern/pdb in the order of candidate_pdbs.
+    for (size_t i = 0; i < candidate_pdbs.size(); ++i) {
+        int count = counts[i];
         if (count > improvement) {
             improvement = count;
             best_pdb_index = i;
@@ -174,8 +209,8 @@ pair<int, int> PatternCollectionGeneratorHillclimbing::find_best_improving_pdb(
 }
 
 bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
-    const PatternDatabase &pdb, const State &sample,
-    const MaxAdditivePDBSubsets &max_additive_subsets) {
+    const PatternDatabase &pdb, const State &sample, int h_collection,
+    const MaxAdditivePDBSubsets &max_additive_subsets) const {
     // h_pattern: h-value of the new pattern
     int h_pattern = pdb.get_value(sample);
 
@@ -183,8 +218,6 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
         return true;
     }
 
-    // h_collection: h-value of the current collection heuristic
-    int h_collection = current_pdbs->get_value(sample);
     if (h_collection == numeric_limits<int>::max())
         return false;
 
@@ -211,7 +244,13 @@ bool PatternCollectionGeneratorHillclimbing::is_heuristic_improved(
 
 void PatternCollectionGeneratorHillclimbing::hill_climbing(
     const TaskProxy &task_proxy) {
-    hill_climbing_timer = new utils::CountdownTimer(max_time);
+    // The threads work at the same time, so their CPU times do not count.
+    hill_climbing_timer = new utils::CountdownTimer(max_time, true);
+    evaluation_pool = utils::make_unique_ptr<utils::ThreadPool>(
+        pdb_construction.get_num_threads());
+
+    cout << "Hill climbing threads: " << evaluation_pool->get_num_threads()
+         << endl;
 
     double average_operator_cost = get_average_operator_cost(task_proxy);
     cout << "Average operator cost: " << average_operator_cost << endl;
@@ -304,6 +343,7 @@ void PatternCollectionGeneratorHillclimbing::hill_climbing(
 
     delete hill_climbing_timer;
     hill_climbing_timer = nullptr;
+    evaluation_pool = nullptr;
 }
 
 PatternCollectionInformation PatternCollectionGeneratorHillclimbing::generate(
@@ -359,10 +399,17 @@ void add_hillclimbing_options(OptionParser &parser) {
         "max_time",
         "maximum time in seconds for improving the initial pattern "
         "collection via hill climbing. If set to 0, no hill climbing "
-        "is performed at all.",
+        "is performed at all. This is wall-clock time, so the limit does "
+        "not depend on the number of construction threads.",
         "infinity",
         Bounds("0.0", "infinity"));
     utils::add_rng_options(parser);
+    /*
+      The construction threads also evaluate the candidate patterns on the
+      samples. The selected patterns do not depend on the number of
+      threads.
+    */
+    ParallelPDBConstruction::add_options_to_parser(parser);
 }
 
 void check_hillclimbing_options(
@@ -502,15 +549,10 @@ static Heuristic *_parse_ipdb(OptionParser &parser) {
     shared_ptr<PatternCollectionGeneratorHillclimbing> pgh =
         make_shared<PatternCollectionGeneratorHillclimbing>(opts);
 
-    Options heuristic_opts;
-    heuristic_opts.set<shared_ptr<AbstractTask>>(
-        "transform", opts.get<shared_ptr<AbstractTask>>("transform"));
-    heuristic_opts.set<bool>(
-        "cache_estimates", opts.get<bool>("cache_estimates"));
+    // Keeps the heuristic and PDB construction options.
+    Options heuristic_opts(opts);
     heuristic_opts.set<shared_ptr<PatternCollectionGenerator>>(
         "patterns", pgh);
-    heuristic_opts.set<bool>(
-        "dominance_pruning", opts.get<bool>("dominance_pruning"));
 
     // Note: in the long run, this should return a shared pointer.
     return new CanonicalPDBsHeuristic(heuristic_opts);
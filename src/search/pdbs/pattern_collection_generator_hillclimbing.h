@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_COLLECTION_GENERATOR_HILLCLIMBING_H
 #define PDBS_PATTERN_COLLECTION_GENERATOR_HILLCLIMBING_H
 
+#include "parallel_pdb_construction.h"
 #include "pattern_generator.h"
 #include "types.h"
 
@@ -19,6 +20,7 @@ class Options;
 namespace utils {
 class CountdownTimer;
 class RandomNumberGenerator;
+class ThreadPool;
 }
 
 namespace pdbs {
@@ -37,8 +39,11 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
     const int min_improvement;
     const double max_time;
     std::shared_ptr<utils::RandomNumberGenerator> rng;
+    // Builds the candidate PDBs; its threads also evaluate the candidates.
+    const ParallelPDBConstruction pdb_construction;
 
     std::unique_ptr<IncrementalCanonicalPDBs> current_pdbs;
+    std::unique_ptr<utils::ThreadPool> evaluation_pool;
 
     // for stats only
     int num_rejected;
@@ -49,7 +54,8 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       relevant variable are considered as candidate patterns. If the candidate
       pattern has not been previously considered (not contained in
       generated_patterns) and if building a PDB for it does not surpass the
-      size limit, then the PDB is built and added to candidate_pdbs.
+      size limit, then the PDB is built and added to candidate_pdbs. The
+      new PDBs are built together (see ParallelPDBConstruction).
 
       The method returns the size of the largest PDB added to candidate_pdbs.
     */
@@ -79,6 +85,11 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Searches for the best improving pdb in candidate_pdbs according to the
       counting approximation and the given samples. Returns the improvement and
       the index of the best pdb in candidate_pdbs.
+
+      The candidates are evaluated by the threads of evaluation_pool, which
+      take the largest PDBs first. Ties are broken by the position in
+      candidate_pdbs, so the result does not depend on the number of
+      threads.
     */
     std::pair<int, int> find_best_improving_pdb(
         std::vector<State> &samples,
@@ -88,12 +99,13 @@ class PatternCollectionGeneratorHillclimbing : public PatternCollectionGenerator
       Returns true iff the h-value of the new pattern (from pdb) plus the
       h-value of all maximal additive subsets from the current pattern
       collection heuristic if the new pattern was added to it is greater than
-      the h-value of the current pattern collection.
+      the h-value of the current pattern collection (h_collection).
     */
     bool is_heuristic_improved(
         const PatternDatabase &pdb,
         const State &sample,
-        const MaxAdditivePDBSubsets &max_additive_subsets);
+        int h_collection,
+        const MaxAdditivePDBSubsets &max_additive_subsets) const;
 
     /*
       This is the core algorithm of this class. The initial PDB collection
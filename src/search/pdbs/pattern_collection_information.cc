@@ -70,12 +70,7 @@ bool PatternCollectionInformation::information_is_valid() const {
 void PatternCollectionInformation::create_pdbs_if_missing() {
     assert(patterns);
     if (!pdbs) {
-        pdbs = make_shared<PDBCollection>();
-        for (const Pattern &pattern : *patterns) {
-            shared_ptr<PatternDatabase> pdb =
-                make_shared<PatternDatabase>(task_proxy, pattern);
-            pdbs->push_back(pdb);
-        }
+        pdbs = pdb_construction.build_pdbs(task_proxy, *patterns);
     }
 }
 
@@ -93,6 +88,11 @@ void PatternCollectionInformation::set_pdbs(const shared_ptr<PDBCollection> &pdb
     assert(information_is_valid());
 }
 
+void PatternCollectionInformation::set_pdb_construction(
+    const ParallelPDBConstruction &pdb_construction_) {
+    pdb_construction = pdb_construction_;
+}
+
 void PatternCollectionInformation::set_max_additive_subsets(
     const shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets_) {
     max_additive_subsets = max_additive_subsets_;
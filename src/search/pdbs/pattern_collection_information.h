@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_COLLECTION_INFORMATION_H
 #define PDBS_PATTERN_COLLECTION_INFORMATION_H
 
+#include "parallel_pdb_construction.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -22,6 +23,8 @@ class PatternCollectionInformation {
     std::shared_ptr<PatternCollection> patterns;
     std::shared_ptr<PDBCollection> pdbs;
     std::shared_ptr<MaxAdditivePDBSubsets> max_additive_subsets;
+    // Used to create missing PDBs
+    ParallelPDBConstruction pdb_construction;
 
     void create_pdbs_if_missing();
     void create_max_additive_subsets_if_missing();
@@ -34,6 +37,7 @@ public:
     ~PatternCollectionInformation() = default;
 
     void set_pdbs(const std::shared_ptr<PDBCollection> &pdbs);
+    void set_pdb_construction(const ParallelPDBConstruction &pdb_construction);
     void set_max_additive_subsets(
         const std::shared_ptr<MaxAdditivePDBSubsets> &max_additive_subsets);
 
@@ -1,6 +1,8 @@
 #include "pattern_database.h"
 
 #include "match_tree.h"
+#include "pdb_cache.h"
+#include "state_block.h"
 
 #include "../task_tools.h"
 
@@ -71,7 +73,9 @@ PatternDatabase::PatternDatabase(
     const TaskProxy &task_proxy,
     const Pattern &pattern,
     bool dump,
-    const vector<int> &operator_costs)
+    const vector<int> &operator_costs,
+    DistanceStorage storage,
+    const PDBCache *cache)
     : pattern(pattern) {
     verify_no_axioms(task_proxy);
     verify_no_conditional_effects(task_proxy);
@@ -94,9 +98,17 @@ PatternDatabase::PatternDatabase(
             utils::exit_with(utils::ExitCode::CRITICAL_ERROR);
         }
     }
-    create_pdb(task_proxy, operator_costs);
-    if (dump)
+    if (!cache || !cache->load(pattern, operator_costs, storage, distances)) {
+        distances = DistanceTable(
+            create_pdb(task_proxy, operator_costs), storage);
+        if (cache)
+            cache->save(pattern, operator_costs, distances);
+    }
+    if (dump) {
         cout << "PDB construction time: " << timer << endl;
+        cout << "PDB distances: " << estimate_distances_bytes() << " bytes"
+             << endl;
+    }
 }
 
 void PatternDatabase::multiply_out(
@@ -188,7 +200,7 @@ void PatternDatabase::build_abstract_operators(
                  variables, operators);
 }
 
-void PatternDatabase::create_pdb(
+vector<int> PatternDatabase::create_pdb(
     const TaskProxy &task_proxy, const vector<int> &operator_costs) {
     VariablesProxy variables = task_proxy.get_variables();
     vector<int> variable_to_index(variables.size(), -1);
@@ -225,7 +237,8 @@ void PatternDatabase::create_pdb(
         }
     }
 
-    distances.reserve(num_states);
+    vector<int> goal_distances;
+    goal_distances.reserve(num_states);
     // first implicit entry: priority, second entry: index for an abstract state
     priority_queues::AdaptiveQueue<size_t> pq;
 
@@ -233,9 +246,9 @@ void PatternDatabase::create_pdb(
     for (size_t state_index = 0; state_index < num_states; ++state_index) {
         if (is_goal_state(state_index, abstract_goals, variables)) {
             pq.push(0, state_index);
-            distances.push_back(0);
+            goal_distances.push_back(0);
         } else {
-            distances.push_back(numeric_limits<int>::max());
+            goal_distances.push_back(numeric_limits<int>::max());
         }
     }
 
@@ -244,7 +257,7 @@ void PatternDatabase::create_pdb(
         pair<int, size_t> node = pq.pop();
         int distance = node.first;
         size_t state_index = node.second;
-        if (distance > distances[state_index]) {
+        if (distance > goal_distances[state_index]) {
             continue;
         }
 
@@ -253,13 +266,14 @@ void PatternDatabase::create_pdb(
         match_tree.get_applicable_operators(state_index, applicable_operators);
         for (const AbstractOperator *op : applicable_operators) {
             size_t predecessor = state_index + op->get_hash_effect();
-            int alternative_cost = distances[state_index] + op->get_cost();
-            if (alternative_cost < distances[predecessor]) {
-                distances[predecessor] = alternative_cost;
+            int alternative_cost = goal_distances[state_index] + op->get_cost();
+            if (alternative_cost < goal_distances[predecessor]) {
+                goal_distances[predecessor] = alternative_cost;
                 pq.push(alternative_cost, predecessor);
             }
         }
     }
+    return goal_distances;
 }
 
 bool PatternDatabase::is_goal_state(
@@ -288,15 +302,31 @@ size_t PatternDatabase::hash_index(const State &state) const {
 }
 
 int PatternDatabase::get_value(const State &state) const {
-    return distances[hash_index(state)];
+    return distances.get(hash_index(state));
+}
+
+void PatternDatabase::get_values(
+    const StateBlock &block, int *h_values) const {
+    int num_block_states = block.size();
+    size_t indices[StateBlock::MAX_SIZE];
+    fill(indices, indices + num_block_states, 0);
+    for (size_t i = 0; i < pattern.size(); ++i) {
+        size_t multiplier = hash_multipliers[i];
+        const int *values = block.get_values(pattern[i]);
+        for (int j = 0; j < num_block_states; ++j) {
+            indices[j] += multiplier * values[j];
+        }
+    }
+    distances.get_values(indices, num_block_states, h_values);
 }
 
 double PatternDatabase::compute_mean_finite_h() const {
     double sum = 0;
     int size = 0;
     for (size_t i = 0; i < distances.size(); ++i) {
-        if (distances[i] != numeric_limits<int>::max()) {
-            sum += distances[i];
+        int h = distances.get(i);
+        if (h != numeric_limits<int>::max()) {
+            sum += h;
             ++size;
         }
     }
@@ -316,4 +346,16 @@ bool PatternDatabase::is_operator_relevant(const OperatorProxy &op) const {
     }
     return false;
 }
+
+void dump_distances_statistics(const PDBCollection &pdbs) {
+    size_t num_bytes = 0;
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        num_bytes += pdb->estimate_distances_bytes();
+    }
+    cout << "PDB distances: " << num_bytes << " bytes for " << pdbs.size()
+         << " PDBs";
+    if (!pdbs.empty())
+        cout << " (" << num_bytes / pdbs.size() << " bytes per PDB)";
+    cout << endl;
+}
 }
@@ -1,6 +1,7 @@
 #ifndef PDBS_PATTERN_DATABASE_H
 #define PDBS_PATTERN_DATABASE_H
 
+#include "distance_table.h"
 #include "types.h"
 
 #include "../task_proxy.h"
@@ -9,6 +10,9 @@
 #include <vector>
 
 namespace pdbs {
+class PDBCache;
+class StateBlock;
+
 class AbstractOperator {
     /*
       This class represents an abstract operator how it is needed for
@@ -80,7 +84,7 @@ class PatternDatabase {
       final h-values for abstract-states.
       dead-ends are represented by numeric_limits<int>::max()
     */
-    std::vector<int> distances;
+    DistanceTable distances;
 
     // multipliers for each variable for perfect hash function
     std::vector<std::size_t> hash_multipliers;
@@ -116,11 +120,12 @@ class PatternDatabase {
     /*
       Computes all abstract operators, builds the match tree (successor
       generator) and then does a Dijkstra regression search to compute
-      all final h-values (stored in distances). operator_costs can
-      specify individual operator costs for each operator for action
-      cost partitioning. If left empty, default operator costs are used.
+      all final h-values (returned, to be stored in distances).
+      operator_costs can specify individual operator costs for each
+      operator for action cost partitioning. If left empty, default
+      operator costs are used.
     */
-    void create_pdb(
+    std::vector<int> create_pdb(
         const TaskProxy &task_proxy,
         const std::vector<int> &operator_costs = std::vector<int>());
 
@@ -147,20 +152,33 @@ public:
       sorted, contains no duplicates and is small enough so that the
       number of abstract states is below numeric_limits<int>::max()
       Parameters:
-       dump:           If set to true, prints the construction time.
+       dump:           If set to true, prints the construction time and
+       the size of the distance table.
        operator_costs: Can specify individual operator costs for each
        operator. This is useful for action cost partitioning. If left
        empty, default operator costs are used.
+       storage:        How the h-values are stored (see DistanceTable).
+       cache:          If given, the h-values are loaded from the cache if
+       possible, and otherwise computed and stored in the cache.
     */
     PatternDatabase(
         const TaskProxy &task_proxy,
         const Pattern &pattern,
         bool dump = false,
-        const std::vector<int> &operator_costs = std::vector<int>());
+        const std::vector<int> &operator_costs = std::vector<int>(),
+        DistanceStorage storage = DistanceStorage::INT32,
+        const PDBCache *cache = nullptr);
     ~PatternDatabase() = default;
 
     int get_value(const State &state) const;
 
+    /*
+      Stores the h-values of all states in the block in h_values, which
+      must have room for StateBlock::MAX_SIZE values. The block must
+      contain the values of all variables in the pattern.
+    */
+    void get_values(const StateBlock &block, int *h_values) const;
+
     // Returns the pattern (i.e. all variables used) of the PDB
     const Pattern &get_pattern() const {
         return pattern;
@@ -171,6 +189,11 @@ public:
         return num_states;
     }
 
+    // Returns the memory used by the h-values
+    std::size_t estimate_distances_bytes() const {
+        return distances.estimate_num_bytes();
+    }
+
     /*
       Returns the average h-value over all states, where dead-ends are
       ignored (they neither increase the sum of all h-values nor the
@@ -184,6 +207,9 @@ public:
     // Returns true iff op has an effect on a variable in the pattern.
     bool is_operator_relevant(const OperatorProxy &op) const;
 };
+
+// Prints the memory used by the h-values of the PDBs, in total and per PDB.
+void dump_distances_statistics(const PDBCollection &pdbs);
 }
 
 #endif
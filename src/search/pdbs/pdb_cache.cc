@@ -0,0 +1,283 @@
+#include "pdb_cache.h"
+
+#include "../task_proxy.h"
+
+#include "../utils/hash.h"
+#include "../utils/system.h"
+
+#include <cerrno>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+#if OPERATING_SYSTEM != WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace pdbs {
+static const char MAGIC[4] = {'K', 'P', 'D', 'B'};
+static const int FORMAT_VERSION = 1;
+
+class TableWriter {
+    ostream &out;
+public:
+    explicit TableWriter(ostream &out) : out(out) {
+    }
+
+    void write_magic() {
+        out.write(MAGIC, sizeof(MAGIC));
+    }
+
+    void write_int(int value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(int));
+    }
+
+    void write_size(uint64_t value) {
+        out.write(reinterpret_cast<const char *>(&value), sizeof(uint64_t));
+    }
+
+    void write_ints(const vector<int> &values) {
+        write_int(values.size());
+        for (int value : values)
+            write_int(value);
+    }
+
+    void write_bytes(const unsigned char *data, size_t num_bytes) {
+        out.write(reinterpret_cast<const char *>(data), num_bytes);
+    }
+};
+
+// Unlike binary_task::TaskReader, running out of data is not an error.
+class TableReader {
+    const unsigned char *pos;
+    const unsigned char *end;
+public:
+    TableReader(const unsigned char *data, size_t size)
+        : pos(data), end(data + size) {
+    }
+
+    bool is_available(size_t num_bytes) const {
+        return static_cast<size_t>(end - pos) >= num_bytes;
+    }
+
+    bool read_magic() {
+        if (!is_available(sizeof(MAGIC)))
+            return false;
+        bool matches = memcmp(pos, MAGIC, sizeof(MAGIC)) == 0;
+        pos += sizeof(MAGIC);
+        return matches;
+    }
+
+    bool read_int(int &value) {
+        if (!is_available(sizeof(int)))
+            return false;
+        memcpy(&value, pos, sizeof(int));
+        pos += sizeof(int);
+        return true;
+    }
+
+    bool read_size(uint64_t &value) {
+        if (!is_available(sizeof(uint64_t)))
+            return false;
+        memcpy(&value, pos, sizeof(uint64_t));
+        pos += sizeof(uint64_t);
+        return true;
+    }
+
+    bool read_ints(vector<int> &values) {
+        int count;
+        if (!read_int(count) || count < 0 ||
+            !is_available(static_cast<size_t>(count) * sizeof(int)))
+            return false;
+        values.resize(count);
+        for (int &value : values)
+            read_int(value);
+        return true;
+    }
+
+    const unsigned char *get_position() const {
+        return pos;
+    }
+};
+
+static size_t compute_task_hash(const TaskProxy &task_proxy) {
+    vector<int> description;
+    VariablesProxy variables = task_proxy.get_variables();
+    description.push_back(variables.size());
+    for (VariableProxy var : variables)
+        description.push_back(var.get_domain_size());
+    OperatorsProxy operators = task_proxy.get_operators();
+    description.push_back(operators.size());
+    for (OperatorProxy op : operators) {
+        PreconditionsProxy preconditions = op.get_preconditions();
+        description.push_back(preconditions.size());
+        for (FactProxy pre : preconditions) {
+            description.push_back(pre.get_variable().get_id());
+            description.push_back(pre.get_value());
+        }
+        EffectsProxy effects = op.get_effects();
+        description.push_back(effects.size());
+        for (EffectProxy effect : effects) {
+            FactProxy fact = effect.get_fact();
+            description.push_back(fact.get_variable().get_id());
+            description.push_back(fact.get_value());
+        }
+    }
+    GoalsProxy goals = task_proxy.get_goals();
+    description.push_back(goals.size());
+    for (FactProxy goal : goals) {
+        description.push_back(goal.get_variable().get_id());
+        description.push_back(goal.get_value());
+    }
+    return hash<vector<int>>()(description);
+}
+
+PDBCache::PDBCache(const string &directory, const TaskProxy &task_proxy)
+    : directory(directory),
+      task_hash(compute_task_hash(task_proxy)) {
+#if OPERATING_SYSTEM == WINDOWS
+    cerr << "The PDB cache is not supported on Windows." << endl;
+    utils::exit_with(ExitCode::UNSUPPORTED);
+#else
+    if (mkdir(directory.c_str(), 0777) == -1 && errno != EEXIST) {
+        cerr << "Could not create PDB cache directory " << directory
+             << "." << endl;
+        utils::exit_with(ExitCode::CRITICAL_ERROR);
+    }
+#endif
+    for (OperatorProxy op : task_proxy.get_operators())
+        default_operator_costs.push_back(op.get_cost());
+}
+
+string PDBCache::get_path(
+    const Pattern &pattern, const vector<int> &operator_costs,
+    DistanceStorage storage) const {
+    vector<int> key;
+    key.push_back(static_cast<int>(storage));
+    key.push_back(pattern.size());
+    key.insert(key.end(), pattern.begin(), pattern.end());
+    key.insert(key.end(), operator_costs.begin(), operator_costs.end());
+    size_t key_hash = hash<vector<int>>()(key) ^ task_hash;
+    ostringstream path;
+    path << directory << "/pdb-" << hex << key_hash << ".bin";
+    return path.str();
+}
+
+#if OPERATING_SYSTEM == WINDOWS
+bool PDBCache::load(const Pattern &, const vector<int> &, DistanceStorage,
+                    DistanceTable &) const {
+    return false;
+}
+
+void PDBCache::save(const Pattern &, const vector<int> &,
+                    const DistanceTable &) const {
+}
+#else
+bool PDBCache::load(
+    const Pattern &pattern, const vector<int> &operator_costs,
+    DistanceStorage storage, DistanceTable &distances) const {
+    const vector<int> &costs =
+        operator_costs.empty() ? default_operator_costs : operator_costs;
+    int fd = open(get_path(pattern, costs, storage).c_str(), O_RDONLY);
+    if (fd == -1)
+        return false;
+    struct stat file_stat;
+    void *mapping = MAP_FAILED;
+    size_t size = 0;
+    if (fstat(fd, &file_stat) == 0 && file_stat.st_size > 0) {
+        size = file_stat.st_size;
+        mapping = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    }
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+    shared_ptr<const unsigned char> memory(
+        static_cast<const unsigned char *>(mapping),
+        [size](const unsigned char *data) {
+            munmap(const_cast<unsigned char *>(data), size);
+        });
+
+    TableReader reader(memory.get(), size);
+    int version;
+    int file_storage;
+    uint64_t file_task_hash;
+    vector<int> file_pattern;
+    vector<int> file_costs;
+    uint64_t num_entries;
+    uint64_t num_overflow_entries;
+    if (!reader.read_magic() ||
+        !reader.read_int(version) || version != FORMAT_VERSION ||
+        !reader.read_int(file_storage) ||
+        file_storage != static_cast<int>(storage) ||
+        !reader.read_size(file_task_hash) || file_task_hash != task_hash ||
+        !reader.read_ints(file_pattern) || file_pattern != pattern ||
+        !reader.read_ints(file_costs) || file_costs != costs ||
+        !reader.read_size(num_entries) ||
+        !reader.read_size(num_overflow_entries))
+        return false;
+
+    unordered_map<size_t, int> overflow;
+    for (uint64_t i = 0; i < num_overflow_entries; ++i) {
+        uint64_t index;
+        int value;
+        if (!reader.read_size(index) || !reader.read_int(value))
+            return false;
+        overflow[index] = value;
+    }
+    const unsigned char *data = reader.get_position();
+    distances = DistanceTable(
+        storage, num_entries, memory, data, move(overflow));
+    if (!reader.is_available(distances.get_num_data_bytes())) {
+        distances = DistanceTable();
+        return false;
+    }
+    return true;
+}
+
+void PDBCache::save(
+    const Pattern &pattern, const vector<int> &operator_costs,
+    const DistanceTable &distances) const {
+    const vector<int> &costs =
+        operator_costs.empty() ? default_operator_costs : operator_costs;
+    DistanceStorage storage = distances.get_storage();
+    string path = get_path(pattern, costs, storage);
+    ostringstream temp_path;
+    temp_path << path << ".tmp-" << getpid() << "-"
+              << hash<thread::id>()(this_thread::get_id());
+    {
+        ofstream out(temp_path.str(), ios::binary);
+        TableWriter writer(out);
+        writer.write_magic();
+        writer.write_int(FORMAT_VERSION);
+        writer.write_int(static_cast<int>(storage));
+        writer.write_size(task_hash);
+        writer.write_ints(pattern);
+        writer.write_ints(costs);
+        writer.write_size(distances.size());
+        writer.write_size(distances.get_overflow().size());
+        for (const auto &entry : distances.get_overflow()) {
+            writer.write_size(entry.first);
+            writer.write_int(entry.second);
+        }
+        writer.write_bytes(
+            distances.get_data(), distances.get_num_data_bytes());
+        if (out.good()) {
+            out.close();
+            if (rename(temp_path.str().c_str(), path.c_str()) == 0)
+                return;
+        }
+    }
+    cerr << "Warning: could not write PDB cache file " << path << endl;
+    remove(temp_path.str().c_str());
+}
+#endif
+}
@@ -0,0 +1,60 @@
+#ifndef PDBS_PDB_CACHE_H
+#define PDBS_PDB_CACHE_H
+
+#include "distance_table.h"
+#include "types.h"
+
+#include <cstddef>
+#include <string>
+#include <vector>
+
+class TaskProxy;
+
+namespace pdbs {
+/*
+  Stores the distance tables of PDBs in a directory, so that later runs on
+  the same task can memory-map them instead of building the PDBs again.
+
+  A table is identified by the pattern, the operator costs, the storage
+  and a hash of the task (variables, operators and goals). These are
+  stored in the file and checked when loading; a file that does not match
+  or cannot be read is treated as missing and overwritten.
+
+  File format (native byte order, sizes as 64-bit and all other numbers
+  as 32-bit integers):
+
+    header:    magic "KPDB", format version, storage, task hash,
+               pattern size, pattern, number of costs, costs
+    table:     number of entries, number of overflow entries, then per
+               overflow entry: index (64-bit), h-value; finally the
+               encoded entries (see DistanceTable)
+
+  Files are written to a temporary name and then renamed, so concurrent
+  runs and threads never see partial files. The cache is not available
+  on Windows.
+*/
+class PDBCache {
+    std::string directory;
+    std::size_t task_hash;
+    std::vector<int> default_operator_costs;
+
+    std::string get_path(
+        const Pattern &pattern, const std::vector<int> &operator_costs,
+        DistanceStorage storage) const;
+public:
+    PDBCache(const std::string &directory, const TaskProxy &task_proxy);
+
+    /*
+      Looks up the table of the given PDB and returns whether it was found.
+      As for PatternDatabase, empty operator_costs stand for the costs of
+      the task.
+    */
+    bool load(const Pattern &pattern, const std::vector<int> &operator_costs,
+              DistanceStorage storage, DistanceTable &distances) const;
+    // Failing to write the file only prints a warning.
+    void save(const Pattern &pattern, const std::vector<int> &operator_costs,
+              const DistanceTable &distances) const;
+};
+}
+
+#endif
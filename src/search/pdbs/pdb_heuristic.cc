@@ -1,5 +1,6 @@
 #include "pdb_heuristic.h"
 
+#include "distance_table.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
@@ -18,7 +19,9 @@ PatternDatabase get_pdb_from_options(const shared_ptr<AbstractTask> &task,
         opts.get<shared_ptr<PatternGenerator>>("pattern");
     Pattern pattern = pattern_generator->generate(task);
     TaskProxy task_proxy(*task);
-    return PatternDatabase(task_proxy, pattern, true);
+    return PatternDatabase(
+        task_proxy, pattern, true, vector<int>(),
+        DistanceStorage(opts.get_enum("storage")));
 }
 
 PDBHeuristic::PDBHeuristic(const Options &opts)
@@ -52,6 +55,7 @@ static Heuristic *_parse(OptionParser &parser) {
         "pattern",
         "pattern generation method",
         "greedy()");
+    add_distance_storage_option_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
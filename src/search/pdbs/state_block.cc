@@ -0,0 +1,38 @@
+#include "state_block.h"
+
+#include "pattern_database.h"
+
+#include "../task_proxy.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace pdbs {
+const int StateBlock::MAX_SIZE;
+
+StateBlock::StateBlock(const PDBCollection &pdbs)
+    : num_states(0) {
+    for (const shared_ptr<PatternDatabase> &pdb : pdbs) {
+        const Pattern &pattern = pdb->get_pattern();
+        variables.insert(variables.end(), pattern.begin(), pattern.end());
+    }
+    sort(variables.begin(), variables.end());
+    variables.erase(unique(variables.begin(), variables.end()),
+                    variables.end());
+    int num_variables = variables.empty() ? 0 : variables.back() + 1;
+    values.resize(num_variables * MAX_SIZE);
+}
+
+void StateBlock::load(const vector<State> &states, int begin, int size) {
+    assert(size <= MAX_SIZE);
+    assert(begin + size <= static_cast<int>(states.size()));
+    num_states = size;
+    for (int var : variables) {
+        int *var_values = &values[var * MAX_SIZE];
+        for (int i = 0; i < size; ++i) {
+            var_values[i] = states[begin + i][var].get_value();
+        }
+    }
+}
+}
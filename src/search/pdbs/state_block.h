@@ -0,0 +1,47 @@
+#ifndef PDBS_STATE_BLOCK_H
+#define PDBS_STATE_BLOCK_H
+
+#include "types.h"
+
+#include <cassert>
+#include <vector>
+
+class State;
+
+namespace pdbs {
+/*
+  A block of unpacked states in structure-of-arrays form: the values of a
+  variable in all states of the block are stored contiguously. PDB lookups
+  for a block (see PatternDatabase::get_values) then consist of loops over
+  the states without dependencies between them, which the compiler can
+  vectorize.
+
+  Only the values of the variables in the patterns of the given PDBs are
+  stored.
+*/
+class StateBlock {
+    // Sorted variables of all patterns
+    std::vector<int> variables;
+    int num_states;
+    // values[var * MAX_SIZE + i] is the value of var in the i-th state
+    std::vector<int> values;
+public:
+    static const int MAX_SIZE = 64;
+
+    explicit StateBlock(const PDBCollection &pdbs);
+
+    // Loads states[begin, begin + size).
+    void load(const std::vector<State> &states, int begin, int size);
+
+    int size() const {
+        return num_states;
+    }
+
+    const int *get_values(int var) const {
+        assert(var * MAX_SIZE < static_cast<int>(values.size()));
+        return &values[var * MAX_SIZE];
+    }
+};
+}
+
+#endif
@@ -1,11 +1,14 @@
 #include "zero_one_pdbs.h"
 
+#include "parallel_pdb_construction.h"
 #include "pattern_database.h"
+#include "state_block.h"
 
 #include "../task_proxy.h"
 
 #include "../utils/logging.h"
 
+#include <algorithm>
 #include <iostream>
 #include <limits>
 #include <memory>
@@ -14,28 +17,47 @@
 using namespace std;
 
 namespace pdbs {
+static bool is_operator_relevant(
+    const Pattern &pattern, const OperatorProxy &op) {
+    for (EffectProxy effect : op.get_effects()) {
+        int var_id = effect.get_fact().get_variable().get_id();
+        if (binary_search(pattern.begin(), pattern.end(), var_id))
+            return true;
+    }
+    return false;
+}
+
 ZeroOnePDBs::ZeroOnePDBs(
-    const TaskProxy &task_proxy, const PatternCollection &patterns) {
-    vector<int> remaining_operator_costs;
+    const TaskProxy &task_proxy, const PatternCollection &patterns,
+    const ParallelPDBConstruction &pdb_construction) {
+    /*
+      An operator is free (action cost partitioning) for all patterns after
+      the first pattern it is relevant for. Storing the index of this
+      pattern per operator is enough to compute the costs of any PDB when
+      it is built, so the PDBs can be built independently.
+    */
     OperatorsProxy operators = task_proxy.get_operators();
-    remaining_operator_costs.reserve(operators.size());
-    for (OperatorProxy op : operators)
-        remaining_operator_costs.push_back(op.get_cost());
-
-    pattern_databases.reserve(patterns.size());
-    for (const Pattern &pattern : patterns) {
-        shared_ptr<PatternDatabase> pdb = make_shared<PatternDatabase>(
-            task_proxy, pattern, false, remaining_operator_costs);
-
-        /* Set cost of relevant operators to 0 for further iterations
-           (action cost partitioning). */
+    int num_patterns = patterns.size();
+    vector<int> free_after(operators.size(), num_patterns);
+    for (int i = 0; i < num_patterns; ++i) {
         for (OperatorProxy op : operators) {
-            if (pdb->is_operator_relevant(op))
-                remaining_operator_costs[op.get_id()] = 0;
+            if (free_after[op.get_id()] == num_patterns &&
+                is_operator_relevant(patterns[i], op))
+                free_after[op.get_id()] = i;
         }
-
-        pattern_databases.push_back(pdb);
     }
+
+    auto get_operator_costs = [&](int pattern_index) {
+            vector<int> operator_costs;
+            operator_costs.reserve(operators.size());
+            for (OperatorProxy op : operators) {
+                operator_costs.push_back(
+                    free_after[op.get_id()] < pattern_index ? 0 : op.get_cost());
+            }
+            return operator_costs;
+        };
+    pattern_databases = move(*pdb_construction.build_pdbs(
+                                 task_proxy, patterns, get_operator_costs));
 }
 
 
@@ -54,6 +76,35 @@ int ZeroOnePDBs::get_value(const State &state) const {
     return h_val;
 }
 
+vector<int> ZeroOnePDBs::get_values(const vector<State> &states) const {
+    const int block_size = StateBlock::MAX_SIZE;
+    int num_states = states.size();
+    vector<int> h_values(num_states);
+    StateBlock block(pattern_databases);
+    bool is_dead_end[block_size];
+    int pdb_values[block_size];
+    for (int begin = 0; begin < num_states; begin += block_size) {
+        int size = min(block_size, num_states - begin);
+        block.load(states, begin, size);
+        fill(is_dead_end, is_dead_end + size, false);
+        int *block_h = &h_values[begin];
+        fill(block_h, block_h + size, 0);
+        for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
+            pdb->get_values(block, pdb_values);
+            for (int j = 0; j < size; ++j) {
+                bool infinite = pdb_values[j] == numeric_limits<int>::max();
+                is_dead_end[j] |= infinite;
+                block_h[j] += infinite ? 0 : pdb_values[j];
+            }
+        }
+        for (int j = 0; j < size; ++j) {
+            if (is_dead_end[j])
+                block_h[j] = numeric_limits<int>::max();
+        }
+    }
+    return h_values;
+}
+
 double ZeroOnePDBs::compute_approx_mean_finite_h() const {
     double approx_mean_finite_h = 0;
     for (const shared_ptr<PatternDatabase> &pdb : pattern_databases) {
@@ -67,4 +118,8 @@ void ZeroOnePDBs::dump() const {
         cout << pdb->get_pattern() << endl;
     }
 }
+
+void ZeroOnePDBs::dump_distances_statistics() const {
+    pdbs::dump_distances_statistics(pattern_databases);
+}
 }
@@ -3,17 +3,28 @@
 
 #include "types.h"
 
+#include <vector>
+
 class State;
 class TaskProxy;
 
 namespace pdbs {
+class ParallelPDBConstruction;
+
 class ZeroOnePDBs {
     PDBCollection pattern_databases;
 public:
-    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns);
+    ZeroOnePDBs(const TaskProxy &task_proxy, const PatternCollection &patterns,
+                const ParallelPDBConstruction &pdb_construction);
     ~ZeroOnePDBs() = default;
 
     int get_value(const State &state) const;
+    /*
+      Returns the h-values of all given states. Like
+      CanonicalPDBs::get_values, the PDBs are looked up for blocks of
+      states at once.
+    */
+    std::vector<int> get_values(const std::vector<State> &states) const;
     /*
       Returns the sum of all mean finite h-values of every PDB.
       This is an approximation of the real mean finite h-value of the Heuristic,
@@ -24,6 +35,8 @@ public:
     */
     double compute_approx_mean_finite_h() const;
     void dump() const;
+    // Prints the memory used by the h-values of the PDBs
+    void dump_distances_statistics() const;
 };
 }
 
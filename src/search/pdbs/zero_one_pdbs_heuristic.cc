@@ -1,5 +1,6 @@
 #include "zero_one_pdbs_heuristic.h"
 
+#include "parallel_pdb_construction.h"
 #include "pattern_generator.h"
 
 #include "../option_parser.h"
@@ -17,7 +18,10 @@ ZeroOnePDBs get_zero_one_pdbs_from_options(
     shared_ptr<PatternCollection> patterns =
         pattern_collection_info.get_patterns();
     TaskProxy task_proxy(*task);
-    return ZeroOnePDBs(task_proxy, *patterns);
+    ZeroOnePDBs zero_one_pdbs(
+        task_proxy, *patterns, ParallelPDBConstruction(opts));
+    zero_one_pdbs.dump_distances_statistics();
+    return zero_one_pdbs;
 }
 
 ZeroOnePDBsHeuristic::ZeroOnePDBsHeuristic(
@@ -62,6 +66,7 @@ static Heuristic *_parse(OptionParser &parser) {
         "patterns",
         "pattern generation method",
         "systematic(1)");
+    ParallelPDBConstruction::add_options_to_parser(parser);
     Heuristic::add_options_to_parser(parser);
 
     Options opts = parser.parse();
@@ -1,4 +1,6 @@
+#include "binary_task.h"
 #include "option_parser.h"
+#include "planner_server.h"
 #include "search_engine.h"
 
 #include "utils/system.h"
@@ -18,8 +20,39 @@ int main(int argc, const char **argv) {
         utils::exit_with(ExitCode::INPUT_ERROR);
     }
 
-    if (string(argv[1]).compare("--help") != 0)
-        read_everything(cin);
+    if (string(argv[1]).compare("--server") == 0) {
+        // The task is read from a file, so that stdin remains free for
+        // the requests.
+        string socket_path;
+        if (argc == 5 && string(argv[3]).compare("--socket") == 0) {
+            socket_path = argv[4];
+        } else if (argc != 3) {
+            cout << OptionParser::usage(argv[0]) << endl;
+            utils::exit_with(ExitCode::INPUT_ERROR);
+        }
+        planner_server::run_server(argv[2], socket_path);
+        return 0;
+    }
+
+    if (string(argv[1]).compare("--convert-task") == 0) {
+        if (argc != 3) {
+            cout << OptionParser::usage(argv[0]) << endl;
+            utils::exit_with(ExitCode::INPUT_ERROR);
+        }
+        ofstream out(argv[2], ios::binary);
+        binary_task::convert_sas_task(cin, out);
+        cout << "Wrote binary task " << argv[2] << endl;
+        return 0;
+    }
+
+    if (string(argv[1]).compare("--help") != 0) {
+        if (binary_task::is_binary_task(0)) {
+            binary_task::read_binary_task(0);
+        } else {
+            binary_task::check_no_binary_task(cin);
+            read_everything(cin);
+        }
+    }
 
     SearchEngine *engine = nullptr;
 
@@ -0,0 +1,650 @@
+#include "planner_server.h"
+
+#include "binary_task.h"
+#include "globals.h"
+#include "heuristic.h"
+#include "option_parser.h"
+#include "search_engine.h"
+
+#include "utils/system.h"
+#include "utils/timer.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <sstream>
+#include <vector>
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+#include <cerrno>
+#include <csignal>
+#include <cstring>
+#include <fcntl.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+using namespace std;
+using utils::ExitCode;
+
+namespace planner_server {
+struct RequestError {
+    string msg;
+
+    explicit RequestError(const string &msg) : msg(msg) {
+    }
+};
+
+static string escape_json(const string &s) {
+    ostringstream out;
+    for (char c : s) {
+        switch (c) {
+        case '"': out << "\\\""; break;
+        case '\\': out << "\\\\"; break;
+        case '\n': out << "\\n"; break;
+        case '\t': out << "\\t"; break;
+        case '\r': out << "\\r"; break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                snprintf(buffer, sizeof(buffer), "\\u%04x", c);
+                out << buffer;
+            } else {
+                out << c;
+            }
+        }
+    }
+    return out.str();
+}
+
+// Checks the number syntax of JSON (e.g., no leading zeros or "+").
+static bool is_json_number(const string &s) {
+    size_t pos = 0;
+    auto skip_digits = [&]() {
+            size_t start = pos;
+            while (pos < s.size() && isdigit(static_cast<unsigned char>(s[pos])))
+                ++pos;
+            return pos > start;
+        };
+    if (pos < s.size() && s[pos] == '-')
+        ++pos;
+    if (pos < s.size() && s[pos] == '0')
+        ++pos;
+    else if (!skip_digits())
+        return false;
+    if (pos < s.size() && s[pos] == '.') {
+        ++pos;
+        if (!skip_digits())
+            return false;
+    }
+    if (pos < s.size() && (s[pos] == 'e' || s[pos] == 'E')) {
+        ++pos;
+        if (pos < s.size() && (s[pos] == '+' || s[pos] == '-'))
+            ++pos;
+        if (!skip_digits())
+            return false;
+    }
+    return pos == s.size();
+}
+
+struct Request {
+    // The id as JSON text; it is echoed in the response.
+    string id = "null";
+    string command;
+    bool has_args = false;
+    vector<string> args;
+    string session;
+    // Same defaults as the options k and q of the top-k search engines,
+    // which mean that the bound is not used
+    int num_plans = -1;
+    double quality_bound = 0.0;
+};
+
+/*
+  Minimal parser for the requests. Values can be strings, arrays of
+  strings, numbers, true, false and null; nested objects are not needed.
+*/
+class RequestParser {
+    const string &line;
+    size_t pos;
+    // Filled while parsing, so that errors can refer to the id
+    Request request;
+
+    void skip_whitespace() {
+        while (pos < line.size() && isspace(static_cast<unsigned char>(line[pos])))
+            ++pos;
+    }
+
+    char peek() {
+        skip_whitespace();
+        if (pos == line.size())
+            throw RequestError("unexpected end of request");
+        return line[pos];
+    }
+
+    void expect(char c) {
+        if (peek() != c)
+            throw RequestError(string("expected '") + c + "' at position " +
+                               to_string(pos));
+        ++pos;
+    }
+
+    string parse_string() {
+        expect('"');
+        string result;
+        while (pos < line.size() && line[pos] != '"') {
+            char c = line[pos++];
+            if (c == '\\') {
+                if (pos == line.size())
+                    break;
+                char escaped = line[pos++];
+                switch (escaped) {
+                case 'n': result += '\n'; break;
+                case 't': result += '\t'; break;
+                case 'r': result += '\r'; break;
+                case 'b': result += '\b'; break;
+                case 'f': result += '\f'; break;
+                case 'u': {
+                    // Only code points up to 0x7f occur in planner arguments.
+                    string hex = line.substr(pos, 4);
+                    if (hex.size() != 4 ||
+                        hex.find_first_not_of("0123456789abcdefABCDEF") !=
+                        string::npos)
+                        throw RequestError("invalid escape sequence in request");
+                    int code = stoi(hex, nullptr, 16);
+                    if (code > 0x7f)
+                        throw RequestError("non-ASCII character in request");
+                    result += static_cast<char>(code);
+                    pos += 4;
+                    break;
+                }
+                default: result += escaped;
+                }
+            } else {
+                result += c;
+            }
+        }
+        expect('"');
+        return result;
+    }
+
+    vector<string> parse_string_array() {
+        vector<string> result;
+        expect('[');
+        if (peek() == ']') {
+            ++pos;
+            return result;
+        }
+        while (true) {
+            result.push_back(parse_string());
+            if (peek() == ']') {
+                ++pos;
+                return result;
+            }
+            expect(',');
+        }
+    }
+
+    // Returns the text of a string, number or literal value.
+    string parse_raw_value() {
+        size_t start = pos;
+        if (peek() == '"') {
+            parse_string();
+        } else {
+            while (pos < line.size() &&
+                   (isalnum(static_cast<unsigned char>(line[pos])) ||
+                    line[pos] == '-' || line[pos] == '+' || line[pos] == '.'))
+                ++pos;
+            if (pos == start)
+                throw RequestError("invalid value at position " + to_string(pos));
+        }
+        return line.substr(start, pos - start);
+    }
+
+    // Only scalar ids are accepted; strings are written out escaped again.
+    string parse_id() {
+        char c = peek();
+        if (c == '"')
+            return "\"" + escape_json(parse_string()) + "\"";
+        if (c != '[' && c != '{') {
+            string value = parse_raw_value();
+            if (value == "true" || value == "false" || value == "null" ||
+                is_json_number(value))
+                return value;
+        }
+        throw RequestError(
+            "\"id\" must be a string, a number, true, false or null");
+    }
+
+    // Unlike stoi and stod, both reject values with trailing characters.
+    int parse_num_plans() {
+        skip_whitespace();
+        string value = parse_raw_value();
+        if (is_json_number(value) &&
+            value.find_first_of(".eE") == string::npos) {
+            try {
+                int num_plans = stoi(value);
+                if (num_plans >= 1)
+                    return num_plans;
+            } catch (exception &) {
+            }
+        }
+        throw RequestError("\"k\" must be an integer of at least 1");
+    }
+
+    double parse_quality_bound() {
+        skip_whitespace();
+        string value = parse_raw_value();
+        if (is_json_number(value)) {
+            try {
+                double quality_bound = stod(value);
+                if (quality_bound >= 1.0)
+                    return quality_bound;
+            } catch (exception &) {
+            }
+        }
+        throw RequestError("\"q\" must be a number of at least 1");
+    }
+
+public:
+    explicit RequestParser(const string &line)
+        : line(line), pos(0) {
+    }
+
+    const string &get_id() const {
+        return request.id;
+    }
+
+    Request parse() {
+        expect('{');
+        if (peek() == '}') {
+            ++pos;
+            return request;
+        }
+        while (true) {
+            string key = parse_string();
+            expect(':');
+            if (key == "args") {
+                request.has_args = true;
+                request.args = parse_string_array();
+            } else if (key == "session") {
+                request.session = parse_string();
+            } else if (key == "k") {
+                request.num_plans = parse_num_plans();
+            } else if (key == "q") {
+                request.quality_bound = parse_quality_bound();
+            } else if (key == "command") {
+                request.command = parse_string();
+            } else if (key == "id") {
+                request.id = parse_id();
+            } else {
+                throw RequestError("unknown key \"" + key + "\"");
+            }
+            if (peek() == '}')
+                break;
+            expect(',');
+        }
+        ++pos;
+        skip_whitespace();
+        if (pos != line.size())
+            throw RequestError("trailing characters after request");
+        return request;
+    }
+};
+
+static string error_response(const string &id, const string &msg) {
+    return "{\"id\": " + id + ", \"status\": \"error\", \"error\": \"" +
+           escape_json(msg) + "\"}";
+}
+
+/*
+  Heuristics created by a request belong to it, except for the predefined
+  ones, which are kept for later requests. Their ownership is shared
+  between the predefinitions and the requests that use them, so that a
+  heuristic whose name is defined again is freed as soon as no session
+  uses it any more.
+*/
+using RequestHeuristics = vector<unique_ptr<Heuristic>>;
+using SharedHeuristics = vector<shared_ptr<Heuristic>>;
+
+static map<Heuristic *, shared_ptr<Heuristic>> predefined_heuristics;
+
+/*
+  Takes the ownership of the heuristics that a request created and
+  returns the ones that only belong to it. The predefined heuristics that
+  it looked up by name are added to used_heuristics.
+*/
+static RequestHeuristics take_request_heuristics(
+    const vector<Heuristic *> &created_heuristics,
+    const vector<Heuristic *> &looked_up_heuristics,
+    SharedHeuristics &used_heuristics) {
+    auto predefinitions = options::Predefinitions<Heuristic *>::instance();
+    RequestHeuristics heuristics;
+    for (Heuristic *heuristic : created_heuristics) {
+        if (predefinitions->contains_object(heuristic))
+            predefined_heuristics[heuristic] = shared_ptr<Heuristic>(heuristic);
+        else
+            heuristics.emplace_back(heuristic);
+    }
+
+    for (Heuristic *heuristic : looked_up_heuristics) {
+        auto it = predefined_heuristics.find(heuristic);
+        if (it != predefined_heuristics.end() &&
+            find(used_heuristics.begin(), used_heuristics.end(),
+                 it->second) == used_heuristics.end())
+            used_heuristics.push_back(it->second);
+    }
+
+    // Heuristics whose names were defined again now only belong to the
+    // requests that use them.
+    for (auto it = predefined_heuristics.begin();
+         it != predefined_heuristics.end();) {
+        if (predefinitions->contains_object(it->first))
+            ++it;
+        else
+            it = predefined_heuristics.erase(it);
+    }
+    return heuristics;
+}
+
+/*
+  A session keeps the search engine of a request, so that later requests
+  can continue its search (see SearchEngine::continue_search).
+*/
+struct Session {
+    // Declared before the engine, which uses them until it is destroyed.
+    SharedHeuristics used_heuristics;
+    RequestHeuristics heuristics;
+    unique_ptr<SearchEngine> engine;
+    string plan_filename;
+    int num_saved_plans;
+};
+
+static map<string, Session> sessions;
+
+static string search_response(const Request &request, const SearchEngine &engine,
+                              int num_saved_plans, const utils::Timer &search_timer,
+                              const utils::Timer &request_timer) {
+    ostringstream response;
+    response << "{\"id\": " << request.id
+             << ", \"status\": \"ok\""
+             << ", \"solution_found\": "
+             << (engine.found_solution() ? "true" : "false")
+             << ", \"num_saved_plans\": " << num_saved_plans
+             << ", \"search_time\": " << search_timer()
+             << ", \"total_time\": " << request_timer()
+             << "}";
+    return response.str();
+}
+
+static string run_search(const Request &request) {
+    // Every request starts with the global defaults of a fresh planner run.
+    static const string default_plan_filename = g_plan_filename;
+    g_plan_filename = default_plan_filename;
+    g_num_previously_generated_plans = 0;
+
+    vector<const char *> argv;
+    argv.push_back("downward");
+    for (const string &arg : request.args)
+        argv.push_back(arg.c_str());
+
+    /*
+      Unlike in normal runs, there is no dry run: it predefines heuristics
+      as null placeholders, which would outlive requests that fail later.
+    */
+    utils::Timer request_timer;
+    vector<Heuristic *> created_heuristics;
+    vector<Heuristic *> looked_up_heuristics;
+    SharedHeuristics used_heuristics;
+    RequestHeuristics heuristics;
+    unique_ptr<SearchEngine> engine;
+    ostringstream parse_error;
+    OptionParser::created_heuristics = &created_heuristics;
+    OptionParser::looked_up_heuristics = &looked_up_heuristics;
+    try {
+        engine.reset(OptionParser::parse_cmd_line(
+                         argv.size(), argv.data(), false, is_unit_cost()));
+    } catch (ArgError &error) {
+        parse_error << error;
+    } catch (ParseError &error) {
+        parse_error << error;
+    }
+    OptionParser::created_heuristics = nullptr;
+    OptionParser::looked_up_heuristics = nullptr;
+    heuristics = take_request_heuristics(
+        created_heuristics, looked_up_heuristics, used_heuristics);
+    if (!parse_error.str().empty())
+        return error_response(request.id, parse_error.str());
+    if (!engine)
+        return error_response(request.id, "no search engine given");
+
+    utils::Timer search_timer;
+    engine->search();
+    search_timer.stop();
+    engine->print_statistics();
+    cout << "Search time: " << search_timer << endl;
+
+    string response = search_response(request, *engine,
+                                      g_num_previously_generated_plans,
+                                      search_timer, request_timer);
+    if (!request.session.empty()) {
+        Session &session = sessions[request.session];
+        // Destroys the engine of a previous session first.
+        session.engine = move(engine);
+        session.used_heuristics = move(used_heuristics);
+        session.heuristics = move(heuristics);
+        session.plan_filename = g_plan_filename;
+        session.num_saved_plans = g_num_previously_generated_plans;
+    }
+    return response;
+}
+
+static string continue_session(const Request &request) {
+    auto it = sessions.find(request.session);
+    if (it == sessions.end())
+        return error_response(request.id,
+                              "unknown session \"" + request.session + "\"");
+    if (request.num_plans == -1 && request.quality_bound == 0.0)
+        return error_response(request.id,
+                              "continuing a session needs \"k\" or \"q\"");
+    Session &session = it->second;
+    utils::Timer request_timer;
+    // Plan files are numbered on from the previous requests of the session.
+    g_plan_filename = session.plan_filename;
+    g_num_previously_generated_plans = session.num_saved_plans;
+
+    utils::Timer search_timer;
+    bool continued = session.engine->continue_search(
+        request.num_plans, request.quality_bound);
+    search_timer.stop();
+    if (!continued) {
+        return error_response(
+            request.id, "the search cannot be continued, start a new session");
+    }
+    session.engine->print_statistics();
+    cout << "Search time: " << search_timer << endl;
+
+    int num_new_plans =
+        g_num_previously_generated_plans - session.num_saved_plans;
+    session.num_saved_plans = g_num_previously_generated_plans;
+    return search_response(request, *session.engine, num_new_plans,
+                           search_timer, request_timer);
+}
+
+// Returns the response to the request line; sets quit on a quit request.
+static string handle_request(const string &line, bool &quit) {
+    Request request;
+    RequestParser parser(line);
+    try {
+        request = parser.parse();
+    } catch (RequestError &error) {
+        // The id, if it came before the error
+        return error_response(parser.get_id(), error.msg);
+    }
+    if (request.command == "quit") {
+        quit = true;
+        return "{\"id\": " + request.id + ", \"status\": \"ok\"}";
+    } else if (request.command == "close") {
+        if (!sessions.erase(request.session))
+            return error_response(request.id,
+                                  "unknown session \"" + request.session + "\"");
+        return "{\"id\": " + request.id + ", \"status\": \"ok\"}";
+    } else if (!request.command.empty()) {
+        return error_response(request.id,
+                              "unknown command \"" + request.command + "\"");
+    }
+    cout << "Request " << request.id << endl;
+    string response;
+    if (request.has_args || request.session.empty())
+        response = run_search(request);
+    else
+        response = continue_session(request);
+    cout << "Request " << request.id << " done" << endl;
+    return response;
+}
+
+#if OPERATING_SYSTEM == LINUX || OPERATING_SYSTEM == OSX
+static bool write_line(int fd, string line) {
+    line += '\n';
+    const char *data = line.data();
+    size_t remaining = line.size();
+    while (remaining > 0) {
+        ssize_t written = write(fd, data, remaining);
+        if (written == -1) {
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        data += written;
+        remaining -= written;
+    }
+    return true;
+}
+
+// Reads the next line from fd into line; returns false at the end of input.
+static bool read_line(int fd, string &buffer, string &line) {
+    while (true) {
+        size_t newline = buffer.find('\n');
+        if (newline != string::npos) {
+            line = buffer.substr(0, newline);
+            buffer.erase(0, newline + 1);
+            return true;
+        }
+        char chunk[4096];
+        ssize_t num_read = read(fd, chunk, sizeof(chunk));
+        if (num_read == -1 && errno == EINTR)
+            continue;
+        if (num_read <= 0) {
+            line.swap(buffer);
+            buffer.clear();
+            return !line.empty();
+        }
+        buffer.append(chunk, num_read);
+    }
+}
+
+// Answers requests from in_fd on out_fd; returns true on a quit request.
+static bool serve(int in_fd, int out_fd) {
+    string buffer;
+    string line;
+    while (read_line(in_fd, buffer, line)) {
+        if (line.find_first_not_of(" \t\r") == string::npos)
+            continue;
+        bool quit = false;
+        string response = handle_request(line, quit);
+        cout.flush();
+        fflush(stdout);
+        if (!write_line(out_fd, response) || quit)
+            return quit;
+    }
+    return false;
+}
+
+static void serve_socket(const string &socket_path) {
+    sockaddr_un address;
+    memset(&address, 0, sizeof(address));
+    address.sun_family = AF_UNIX;
+    if (socket_path.size() >= sizeof(address.sun_path)) {
+        cerr << "socket path too long: " << socket_path << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    strcpy(address.sun_path, socket_path.c_str());
+
+    int server_fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    unlink(socket_path.c_str());
+    if (server_fd == -1 ||
+        bind(server_fd, reinterpret_cast<sockaddr *>(&address),
+             sizeof(address)) == -1 ||
+        listen(server_fd, 1) == -1) {
+        cerr << "could not listen on " << socket_path << ": "
+             << strerror(errno) << endl;
+        utils::exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    cout << "Listening on " << socket_path << endl;
+
+    bool quit = false;
+    while (!quit) {
+        int connection_fd = accept(server_fd, nullptr, nullptr);
+        if (connection_fd == -1) {
+            if (errno == EINTR)
+                continue;
+            cerr << "accept failed: " << strerror(errno) << endl;
+            utils::exit_with(ExitCode::CRITICAL_ERROR);
+        }
+        quit = serve(connection_fd, connection_fd);
+        close(connection_fd);
+    }
+    close(server_fd);
+    unlink(socket_path.c_str());
+}
+
+static void read_task(const string &task_path) {
+    int fd = open(task_path.c_str(), O_RDONLY);
+    if (fd != -1 && binary_task::is_binary_task(fd)) {
+        binary_task::read_binary_task(fd);
+        close(fd);
+        return;
+    }
+    if (fd != -1)
+        close(fd);
+    ifstream task_file(task_path);
+    if (!task_file) {
+        cerr << "could not open task file " << task_path << endl;
+        utils::exit_with(ExitCode::INPUT_ERROR);
+    }
+    binary_task::check_no_binary_task(task_file);
+    read_everything(task_file);
+}
+
+void run_server(const string &task_path, const string &socket_path) {
+    // Clients that disconnect early must not terminate the server.
+    signal(SIGPIPE, SIG_IGN);
+    if (!socket_path.empty()) {
+        read_task(task_path);
+        serve_socket(socket_path);
+        return;
+    }
+    // Keep stdout for the responses and send all log output to stderr.
+    cout.flush();
+    fflush(stdout);
+    int response_fd = dup(STDOUT_FILENO);
+    if (response_fd == -1 || dup2(STDERR_FILENO, STDOUT_FILENO) == -1) {
+        cerr << "could not redirect output: " << strerror(errno) << endl;
+        utils::exit_with(ExitCode::CRITICAL_ERROR);
+    }
+    read_task(task_path);
+    serve(STDIN_FILENO, response_fd);
+    close(response_fd);
+}
+#else
+void run_server(const string &, const string &) {
+    cerr << "server mode is not supported on this operating system" << endl;
+    utils::exit_with(ExitCode::UNSUPPORTED);
+}
+#endif
+}
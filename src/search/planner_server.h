@@ -0,0 +1,47 @@
+#ifndef PLANNER_SERVER_H
+#define PLANNER_SERVER_H
+
+#include <string>
+
+/*
+  Server mode of the planner: the task is read and grounded once, and
+  afterwards the planner answers a stream of search requests. Requests
+  and responses are JSON objects, one per line:
+
+    {"id": 1, "args": ["--heuristic", "h=lmcut()", "--search", "kstar(h, k=10)"]}
+    {"id": 1, "status": "ok", "solution_found": true, "search_time": 0.01, ...}
+
+  "args" are the command line arguments of a normal planner run (without
+  the task). Unlike "search_time", "total_time" includes the construction
+  of heuristics defined in the request. Every request creates a new search
+  engine and thus a new state registry and search space. Heuristics
+  predefined with --heuristic are kept between requests, so later requests
+  can refer to them by name without repeating their precomputation (e.g.,
+  PDB or merge-and-shrink construction). Defining a name again replaces the
+  heuristic; the old one is freed as soon as no session uses it any more.
+  All other heuristics of a request are freed when it finishes.
+
+  A request with a "session" name keeps its search engine. A later request
+  for the same session without "args" continues the search with new values
+  for "k" and "q" (same meaning as the options of kstar) and only reports
+  and saves the additional plans. It needs at least one of them; "k" must
+  be an integer of at least 1 and "q" a number of at least 1.
+  {"command": "close", "session": ...} discards a session and frees its
+  heuristics.
+
+  The "id" of a request can be a string, a number, true, false or null.
+
+  Requests are read from stdin and responses written to stdout, or, if a
+  socket path is given, both are exchanged over a Unix domain socket that
+  accepts one connection at a time. Log output of the searches is written
+  to stderr in the first case. The server stops at the end of the input or
+  on the request {"command": "quit"}.
+
+  Fatal errors during a search (e.g., running out of memory) still
+  terminate the planner. Only Unix systems are supported.
+*/
+namespace planner_server {
+void run_server(const std::string &task_path, const std::string &socket_path);
+}
+
+#endif
@@ -22,6 +22,9 @@ public:
         const options::Options &opts, std::unique_ptr<PotentialFunction> function);
     // Define in .cc file to avoid include in header.
     ~PotentialHeuristic();
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
 };
 }
 
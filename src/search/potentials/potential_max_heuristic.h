@@ -23,6 +23,9 @@ public:
         const options::Options &opts,
         std::vector<std::unique_ptr<PotentialFunction>> &&functions);
     ~PotentialMaxHeuristic() = default;
+    virtual ParallelEvaluation get_parallel_evaluation() const override {
+        return ParallelEvaluation::CONCURRENT;
+    }
 };
 }
 
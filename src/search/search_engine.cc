@@ -77,6 +77,10 @@ void SearchEngine::search() {
          << " [t=" << utils::g_timer << "]" << endl;
 }
 
+bool SearchEngine::continue_search(int, double) {
+    return false;
+}
+
 bool SearchEngine::check_goal_and_set_plan(const GlobalState &state) {
     if (test_goal(state)) {
         cout << "Solution found!" << endl;
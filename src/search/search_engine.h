@@ -54,6 +54,13 @@ public:
     SearchStatus get_status() const;
     const Plan &get_plan() const;
     virtual void search();
+    /*
+      Engines that enumerate plans (see kstar::KStar) can continue a
+      finished search with new values for the number of plans and the
+      quality bound. Returns false if the engine cannot continue, in which
+      case a new search is needed.
+    */
+    virtual bool continue_search(int num_plans, double quality_bound);
     const SearchStatistics &get_statistics() const {return statistics; }
     void set_bound(int b) {bound = b; }
     int get_bound() {return bound; }
@@ -225,7 +225,7 @@ SearchStatus EnforcedHillClimbingSearch::ehc() {
                 if (d_counts.count(d) == 0) {
                     d_counts[d] = make_pair(0, 0);
                 }
-                pair<int, int> &d_pair = d_counts[d];
+                pair<int, int64_t> &d_pair = d_counts[d];
                 d_pair.first += 1;
                 d_pair.second += statistics.get_expanded() - last_num_expanded;
 
@@ -255,7 +255,7 @@ void EnforcedHillClimbingSearch::print_statistics() const {
         int depth = count.first;
         int phases = count.second.first;
         assert(phases != 0);
-        int total_expansions = count.second.second;
+        int64_t total_expansions = count.second.second;
         cout << "EHC phases of depth " << depth << ": " << phases
              << " - Avg. Expansions: "
              << static_cast<double>(total_expansions) / phases << endl;
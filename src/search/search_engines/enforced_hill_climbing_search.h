@@ -42,9 +42,9 @@ class EnforcedHillClimbingSearch : public SearchEngine {
     int current_phase_start_g;
 
     // Statistics
-    std::map<int, std::pair<int, int>> d_counts;
+    std::map<int, std::pair<int, int64_t>> d_counts;
     int num_ehc_phases;
-    int last_num_expanded;
+    int64_t last_num_expanded;
 
     void insert_successor_into_open_list(
         const EvaluationContext &eval_context,
@@ -6,13 +6,18 @@
 #include "../globals.h"
 #include "../heuristic.h"
 #include "../option_parser.h"
+#include "../parallel_heuristic_evaluator.h"
 #include "../plugin.h"
 #include "../pruning_method.h"
 #include "../successor_generator.h"
+#include "../utils/memory.h"
+#include "../utils/timer.h"
 #include "../utils/util.h"
 #include "../algorithms/ordered_set.h"
 #include "../open_lists/open_list_factory.h"
 
+#include <unordered_set>
+
 using namespace std;
 
 namespace top_k_eager_search {
@@ -21,12 +26,16 @@ TopKEagerSearch::TopKEagerSearch(const Options &opts)
       reopen_closed_nodes(opts.get<bool>("reopen_closed")),
       number_of_plans(opts.get<int>("k")),
       quality_bound(opts.get<double>("q")),
+      pruned_by_bound(false),
       open_list(opts.get<shared_ptr<OpenListFactory>>("open")->
                 create_state_open_list()),
       f_evaluator(opts.get<ScalarEvaluator *>("f_eval", nullptr)),
       preferred_operator_heuristics(opts.get_list<Heuristic *>("preferred")),
       pruning_method(opts.get<shared_ptr<PruningMethod>>("pruning")),
+      num_evaluation_threads(opts.get<int>("evaluation_threads")),
+      lazy_evaluation(opts.get<bool>("lazy_evaluation")),
       interrupted(false),
+      heap_version(0),
       most_expensive_successor(-1),
       next_node_f(-1),
       first_plan_found(false),
@@ -35,6 +44,8 @@ TopKEagerSearch::TopKEagerSearch(const Options &opts)
         cerr << "Either the number of plans or the quality bound should be specified and be at least 1." << endl;
         utils::exit_with(utils::ExitCode::INPUT_ERROR);
     }
+    if (lazy_evaluation)
+        evaluation_deferred = utils::make_unique_ptr<PerStateInformation<bool>>();
     /*
     if (number_of_plans >= 1 && quality_bound >= 1.0) {
         cerr << "Either the number of plans or the quality bound should be specified, not both." << endl;
@@ -43,6 +54,9 @@ TopKEagerSearch::TopKEagerSearch(const Options &opts)
     */
 }
 
+TopKEagerSearch::~TopKEagerSearch() {
+}
+
 void TopKEagerSearch::initialize() {
     cout << "Conducting best first search"
          << (reopen_closed_nodes ? " with" : " without")
@@ -68,6 +82,29 @@ void TopKEagerSearch::initialize() {
     heuristics.assign(hset.begin(), hset.end());
     assert(!heuristics.empty());
 
+    if (lazy_evaluation) {
+        cout << "Evaluating states lazily when they are fetched" << endl;
+        if (num_evaluation_threads != 1) {
+            cout << "Lazy evaluation evaluates one state at a time, "
+                 << "evaluating serially" << endl;
+        }
+    } else if (num_evaluation_threads != 1) {
+        if (ParallelHeuristicEvaluator::can_evaluate_in_parallel(heuristics)) {
+            int num_threads = num_evaluation_threads;
+            if (num_threads == 0)
+                num_threads = utils::get_hardware_concurrency();
+            utils::Timer setup_timer(true);
+            parallel_evaluator =
+                utils::make_unique_ptr<ParallelHeuristicEvaluator>(
+                    heuristics, num_threads);
+            cout << "Evaluating successors with " << num_threads
+                 << " threads (set up in " << setup_timer << ")" << endl;
+        } else {
+            cout << "The heuristics cannot be evaluated in parallel, "
+                 << "evaluating successors serially" << endl;
+        }
+    }
+
     const GlobalState &initial_state = state_registry.get_initial_state();
     for (Heuristic *heuristic : heuristics) {
         heuristic->notify_initial_state(initial_state);
@@ -125,7 +162,7 @@ SearchStatus TopKEagerSearch::step() {
     //         if (test_goal(s)) {
     //             goal_state = s.get_id();
     //             first_plan_found = true;
-    //             sort_and_remove(s);
+    //             finalize_incoming_heap(s);
     //         }
     //         return INTERRUPTED;
     //     }
@@ -169,7 +206,7 @@ SearchStatus TopKEagerSearch::step() {
         if (test_goal(s)) {
             goal_state = s.get_id();
             first_plan_found = true;
-            sort_and_remove(s);
+            finalize_incoming_heap(s);
         }
         node.unclose();
         EvaluationContext eval_context(s, node.get_g(), true, &statistics);
@@ -197,12 +234,13 @@ SearchStatus TopKEagerSearch::step() {
             bound = (int) ( (optimal_solution_cost * quality_bound) + 0.00001) + 2;
             cout << ", the search bound is updated to " << bound - 1 << endl;
         }
-        sort_and_remove(s);
+        finalize_incoming_heap(s);
 
         node.unclose();
         EvaluationContext eval_context(s, node.get_g(), true, &statistics);
         open_list->insert(eval_context, s.get_id());
-        next_node_f = eval_context.get_heuristic_value(f_evaluator);
+        if (f_evaluator)
+            next_node_f = eval_context.get_heuristic_value(f_evaluator);
 
         return FIRST_PLAN_FOUND;
     }
@@ -231,16 +269,52 @@ SearchStatus TopKEagerSearch::step() {
     ordered_set::OrderedSet<const GlobalOperator *> preferred_operators =
             collect_preferred_operators(eval_context, preferred_operator_heuristics);
 
+    // Without an f evaluator (greedy search), there are no f layers
     int prev_f = next_node_f;
-    next_node_f = eval_context.get_heuristic_value(f_evaluator);
+    if (f_evaluator)
+        next_node_f = eval_context.get_heuristic_value(f_evaluator);
+
+    /*
+      With parallel evaluation, all successors are generated first and the
+      new ones are evaluated at once. The loop below then processes the
+      successors in the same order as with serial evaluation.
+    */
+    vector<StateID> successor_ids;
+    vector<int> successor_cache_index;
+    vector<HeuristicCache> successor_caches;
+    if (parallel_evaluator) {
+        successor_ids.resize(applicable_ops.size(), StateID::no_state);
+        successor_cache_index.resize(applicable_ops.size(), -1);
+        vector<GlobalState> new_successors;
+        unordered_set<StateID> new_successor_ids;
+        for (size_t i = 0; i < applicable_ops.size(); ++i) {
+            const GlobalOperator *op = applicable_ops[i];
+            if ((node.get_real_g() + op->get_cost()) >= bound)
+                continue;
+            GlobalState succ_state =
+                state_registry.get_successor_state(s, *op);
+            successor_ids[i] = succ_state.get_id();
+            if (search_space.get_node(succ_state).is_new() &&
+                new_successor_ids.insert(succ_state.get_id()).second) {
+                successor_cache_index[i] = new_successors.size();
+                new_successors.push_back(succ_state);
+            }
+        }
+        successor_caches =
+            parallel_evaluator->evaluate(new_successors, statistics);
+    }
 
     bool added_goal_successor = false;
-    for (const GlobalOperator *op : applicable_ops) {
+    for (size_t i = 0; i < applicable_ops.size(); ++i) {
+        const GlobalOperator *op = applicable_ops[i];
         if ((node.get_real_g() + op->get_cost()) >= bound) {
+            pruned_by_bound = true;
             continue;
         }
 
-        GlobalState succ_state = state_registry.get_successor_state(s, *op);
+        GlobalState succ_state = parallel_evaluator ?
+            state_registry.lookup_state(successor_ids[i]) :
+            state_registry.get_successor_state(s, *op);
         if (verbosity >= kstar::Verbosity::NORMAL) {
             if (test_goal(succ_state)) {
                 cout << "[TKES] Found goal successor state" << endl;
@@ -284,7 +358,20 @@ SearchStatus TopKEagerSearch::step() {
             // TODO: Make this less fragile.
             int succ_g = node.get_g() + get_adjusted_cost(*op);
 
-            EvaluationContext eval_context(
+            if (lazy_evaluation) {
+                succ_node.open(node, op);
+                (*evaluation_deferred)[succ_state] = true;
+                insert_deferred(eval_context, node, is_preferred,
+                                succ_state.get_id());
+                continue;
+            }
+
+            assert(!parallel_evaluator || successor_cache_index[i] != -1);
+            EvaluationContext eval_context = parallel_evaluator ?
+                EvaluationContext(
+                    successor_caches[successor_cache_index[i]], succ_g,
+                    is_preferred, &statistics) :
+                EvaluationContext(
                     succ_state, succ_g, is_preferred, &statistics);
             statistics.inc_evaluated_states();
 
@@ -331,9 +418,15 @@ SearchStatus TopKEagerSearch::step() {
                     statistics.inc_reopened();
                 }
                 succ_node.reopen(node, op);
+                refresh_incoming_heap(succ_node);
 
                 EvaluationContext eval_context(
                         succ_state, succ_node.get_g(), is_preferred, &statistics);
+                if (lazy_evaluation && (*evaluation_deferred)[succ_state]) {
+                    // The state is queued with its own values from now on
+                    (*evaluation_deferred)[succ_state] = false;
+                    statistics.inc_evaluated_states();
+                }
 
                 /*
                   Note: our old code used to retrieve the h value from
@@ -359,6 +452,12 @@ SearchStatus TopKEagerSearch::step() {
                 // Note that this could cause an incompatibility between
                 // the g-value and the actual path that is traced back.
                 succ_node.update_parent(node, op);
+                refresh_incoming_heap(succ_node);
+                if (lazy_evaluation && (*evaluation_deferred)[succ_state]) {
+                    // The old key may be above the f value with the new g
+                    insert_deferred(eval_context, node, is_preferred,
+                                    succ_state.get_id());
+                }
             }
 
         } else {
@@ -396,79 +495,126 @@ void TopKEagerSearch::interrupt() {
 void TopKEagerSearch::add_incoming_edge(SearchNode node,
                                          const GlobalOperator *op,
                                          SearchNode succ_node) {
-    auto sap = make_shared<StateActionPair>(node.get_state_id(),
-            succ_node.get_state_id(),
-            op, &state_registry,
-            &search_space);
-    GlobalState succ_state = succ_node.get_state();
-
-    bool duplicate =
-            std::find_if(incomming_heap[succ_state].begin(),
-                    incomming_heap[succ_state].end(),
-                    [=](const shared_ptr<StateActionPair>& other) {return *other == *sap;})
-            != incomming_heap[succ_state].end();
-
-    if (duplicate)
+    StateID from = node.get_state_id();
+    pair<int, int> key = make_pair(from.hash(), op->get_index());
+    auto it = incoming_edges.find(key);
+    if (it != incoming_edges.end()) {
+        // The edge is known, but node may have been reopened since
+        StateActionPair &sap = saps[it->second];
+        if (sap.from_g != node.get_g()) {
+            sap.refresh(node.get_g(), sap.to_g);
+            refresh_incoming_heap(succ_node);
+        }
         return;
+    }
 
-    incomming_heap[succ_state].push_back(sap);
-    std::stable_sort(incomming_heap[succ_state].begin(), incomming_heap[succ_state].end(),Cmp<Sap>());
+    // The g value of new successors is not set yet. The cached delta
+    // is recomputed when the incoming heap is finalized.
+    int succ_g = succ_node.is_open() || succ_node.is_closed() ? succ_node.get_g() : 0;
+    SapID sap = saps.add(StateActionPair(from, succ_node.get_state_id(),
+                                         op->get_index(), node.get_g(), succ_g));
+    incoming_edges[key] = sap;
+    GlobalState succ_state = succ_node.get_state();
+    kstar::IncomingHeapInfo &info = incomming_heap[succ_state];
+    if (info.finalized) {
+        // The successor is already closed, so its g value is known. Should
+        // it change because of this edge, refresh_incoming_heap rebuilds H_in.
+        info.root = in_heap_nodes.insert(info.root, sap, saps[sap].get_delta());
+        ++heap_version;
+    } else {
+        info.pending.push_back(sap);
+    }
     //++num_saps;
 }
 
-// Recursively trace the search path to state and add all top elements
-// of incoming heaps
+// Trace the search path to state and make sure that the tree heaps of all
+// states on it are up to date. Only states whose tree heap was built for an
+// older heap version are visited, and a tree heap is only rebuilt if its
+// parent's heap or its own root_in edge changed.
 void TopKEagerSearch::init_tree_heap(GlobalState& state) {
     if (verbosity >= kstar::Verbosity::VERBOSE) {
         cout << "[TKES] Initializing tree heap for state " << state.get_id() << endl;
     }
-    StateID parent_id = search_space.search_node_infos[state].parent_state_id;
-    if (verbosity >= kstar::Verbosity::VERBOSE) {
-       cout << "[TKES] Parent state " << parent_id << endl;
+    vector<GlobalState> outdated;
+    StateID id = state.get_id();
+    while (id != StateID::no_state) {
+        GlobalState s = state_registry.lookup_state(id);
+        if (tree_heap[s].version == heap_version)
+            break;
+        outdated.push_back(s);
+        id = search_space.search_node_infos[s].parent_state_id;
+    }
+    int parent_root = kstar::TreeHeap::NO_NODE;
+    if (id != StateID::no_state) {
+        parent_root = tree_heap[state_registry.lookup_state(id)].root;
     }
-    tree_heap[state].clear();
-    if (parent_id != StateID::no_state) {
-        GlobalState parent_state = state_registry.lookup_state(parent_id);
-        init_tree_heap(parent_state);
-        tree_heap[state].insert(tree_heap[state].end(),
-                tree_heap[parent_state].begin(),
-                tree_heap[parent_state].end());
+    for (auto it = outdated.rbegin(); it != outdated.rend(); ++it) {
+        update_tree_heap(*it, parent_root);
+        parent_root = tree_heap[*it].root;
     }
     if (verbosity >= kstar::Verbosity::VERBOSE) {
-        cout << "[TKES] Incoming heap for state " << state.get_id() << " is" << endl;
-        dump_incoming_heap(state);
+        cout << "[TKES] Tree heap for state " << state.get_id() << " is" << endl;
+        dump_tree_heap(state);
     }
-    // Copy root_in[state] to tree_heap[heap]
-    if (!incomming_heap[state].empty()) {
+}
+
+// H_T(state) is H_T(parent) with H_in(state) inserted
+void TopKEagerSearch::update_tree_heap(const GlobalState &state, int parent_root) {
+    kstar::TreeHeapInfo &info = tree_heap[state];
+    int in_root = incomming_heap[state].root;
+    bool changed = info.version == -1
+                   || info.parent_root != parent_root
+                   || info.in_root != in_root;
+    if (changed) {
         if (verbosity >= kstar::Verbosity::VERBOSE) {
-            cout << "[TKES] Pushing into tree heap" << endl;
+            cout << "[TKES] Rebuilding tree heap for state " << state.get_id() << endl;
+        }
+        info.parent_root = parent_root;
+        info.in_root = in_root;
+        if (in_root != kstar::InHeap::NO_NODE) {
+            info.root = tree_heap_nodes.insert(parent_root, in_root,
+                                               in_heap_nodes[in_root].key);
+        } else {
+            info.root = parent_root;
         }
-        Sap &p = incomming_heap[state].front();
-        tree_heap[state].push_back(p);
     }
-    std::stable_sort(tree_heap[state].begin(), tree_heap[state].end(), Cmp<Sap>());
-    if (verbosity >= kstar::Verbosity::VERBOSE) {
-        cout << "[TKES] Tree heap for state " << state.get_id() << " is" << endl;
-        dump_tree_heap(state);
+    info.version = heap_version;
+}
+
+void TopKEagerSearch::get_incoming_edges(const GlobalState &s,
+                                         vector<SapID> &edges) const {
+    const kstar::IncomingHeapInfo &info = incomming_heap[s];
+    edges.insert(edges.end(), info.pending.begin(), info.pending.end());
+    vector<int> heap_nodes;
+    in_heap_nodes.collect(info.root, heap_nodes);
+    for (int heap_node : heap_nodes) {
+        edges.push_back(in_heap_nodes[heap_node].value);
     }
 }
 
 void TopKEagerSearch::dump_incoming_heap(const GlobalState& s) const {
-    for (Sap sap: incomming_heap[s]) {
-        cout << sap->get_from_state().get_id() << "  ->  " << sap->get_to_state().get_id();
-        cout <<" [ " << sap->op->get_name();
-        cout << "/"<< sap->op->get_cost() << "]" << endl;
+    vector<SapID> edges;
+    get_incoming_edges(s, edges);
+    for (SapID id : edges) {
+        const StateActionPair &sap = saps[id];
+        cout << sap.from << "  ->  " << sap.to;
+        cout <<" [ " << sap.get_op()->get_name();
+        cout << "/"<< sap.get_op()->get_cost() << "]" << endl;
     }
 }
 void TopKEagerSearch::dump_tree_heap(const GlobalState& s) const {
-    for (Sap sap: tree_heap[s]) {
-        cout << sap->get_from_state().get_id() << "  ->  " << sap->get_to_state().get_id();
-        cout <<" [ " << sap->op->get_name();
-        cout << "/"<< sap->op->get_cost() << "]" << endl;
+    vector<int> heap_nodes;
+    tree_heap_nodes.collect(tree_heap[s].root, heap_nodes);
+    for (int heap_node : heap_nodes) {
+        const StateActionPair &sap =
+            saps[in_heap_nodes[tree_heap_nodes[heap_node].value].value];
+        cout << sap.from << "  ->  " << sap.to;
+        cout <<" [ " << sap.get_op()->get_name();
+        cout << "/"<< sap.get_op()->get_cost() << "]" << endl;
     }
 }
 
-std::string TopKEagerSearch::get_node_label(StateActionPair &edge) {
+std::string TopKEagerSearch::get_node_label(const StateActionPair &edge) {
     int from = state_registry.lookup_state(edge.from)[0];
     int to = state_registry.lookup_state(edge.to)[0];
     std::string node_name = std::to_string(from) + std::to_string(to)
@@ -476,10 +622,10 @@ std::string TopKEagerSearch::get_node_label(StateActionPair &edge) {
     return node_name;
 }
 
-std::string TopKEagerSearch::get_node_name(StateActionPair &edge) {
+std::string TopKEagerSearch::get_node_name(const StateActionPair &edge) {
     string from = state_registry.lookup_state(edge.from).get_state_tuple();
     string to = state_registry.lookup_state(edge.to).get_state_tuple();
-    std::string node_name = "(" + from +","+ to + ") " + edge.op->get_name();
+    std::string node_name = "(" + from +","+ to + ") " + edge.get_op()->get_name();
     return node_name;
 }
 
@@ -494,32 +640,71 @@ std::string TopKEagerSearch::get_node_name(StateActionPair &edge) {
 // removing the tree edge
 void TopKEagerSearch::remove_tree_edge(GlobalState s)  {
     SearchNodeInfo info = search_space.search_node_infos[s];
+    if (info.creating_operator == -1)
+        return;
     int creating_op_index = g_operators[info.creating_operator].get_index();
     StateID parent_state_id = info.parent_state_id;
-    int tree_edge_pos = -1;
+    kstar::IncomingHeapInfo &heap_info = incomming_heap[s];
+    vector<SapID> &pending = heap_info.pending;
 
-    for (size_t i = 0; i < incomming_heap[s].size(); ++i) {
-        Sap sap = incomming_heap[s][i];
-        if (sap->get_delta() > 0)
+    for (size_t i = 0; i < pending.size(); ++i) {
+        const StateActionPair &sap = saps[pending[i]];
+        if (sap.get_delta() > 0)
             continue;
-        if(sap->op->get_index() == creating_op_index
-           && parent_state_id == sap->from) {
-            tree_edge_pos = i;
+        if(sap.op_index == creating_op_index
+           && parent_state_id == sap.from) {
+            heap_info.tree_edge = pending[i];
+            pending.erase(pending.begin() + i);
             break;
         }
     }
-
-    if (tree_edge_pos != -1) {
-        incomming_heap[s].erase(incomming_heap[s].begin() + tree_edge_pos);
-    }
 }
 
 
-// Sort the incoming heap edges according to their delta
-// value and remove the tree edge
-void TopKEagerSearch::sort_and_remove(GlobalState s) {
-    std::stable_sort(incomming_heap[s].begin(), incomming_heap[s].end(), Cmp<Sap>());
+// Sort the incoming edges according to their delta value once the state is
+// closed, remove the tree edge and build H_in from the remaining edges
+void TopKEagerSearch::finalize_incoming_heap(GlobalState s) {
+    kstar::IncomingHeapInfo &info = incomming_heap[s];
+    if (info.finalized)
+        return;
+    int g = search_space.get_node(s).get_g();
+    for (SapID sap : info.pending) {
+        saps[sap].refresh(saps[sap].from_g, g);
+    }
+    std::stable_sort(info.pending.begin(), info.pending.end(),
+                     [this](SapID lhs, SapID rhs) {
+                         return saps[lhs] < saps[rhs];
+                     });
     remove_tree_edge(s);
+    vector<pair<SapID, int>> entries;
+    entries.reserve(info.pending.size());
+    for (SapID sap : info.pending) {
+        entries.push_back(make_pair(sap, saps[sap].get_delta()));
+    }
+    info.root = in_heap_nodes.build_from_sorted(entries);
+    info.finalized = true;
+    vector<SapID>().swap(info.pending);
+    ++heap_version;
+}
+
+// Called whenever the cached delta of an edge into node may be outdated,
+// i.e., the g value of node or of the source of one of its incoming edges
+// changed. The keys of H_in cannot change, so the heap is built anew.
+void TopKEagerSearch::refresh_incoming_heap(SearchNode node) {
+    GlobalState s = node.get_state();
+    kstar::IncomingHeapInfo &info = incomming_heap[s];
+    if (!info.finalized)
+        return;
+    get_incoming_edges(s, info.pending);
+    if (info.tree_edge != -1) {
+        info.pending.push_back(info.tree_edge);
+        info.tree_edge = -1;
+    }
+    info.root = kstar::InHeap::NO_NODE;
+    info.finalized = false;
+    ++heap_version;
+    if (node.is_closed())
+        finalize_incoming_heap(s);
 }
 
 pair<SearchNode, bool> TopKEagerSearch::fetch_next_node() {
@@ -540,7 +725,10 @@ pair<SearchNode, bool> TopKEagerSearch::fetch_next_node() {
             all_nodes_expanded = true;
             return make_pair(dummy_node, false);
         }
-        StateID id = open_list->remove_min(nullptr);
+        // Lazy A* compares the f value of the fetched state with its key
+        vector<int> key;
+        bool need_key = lazy_evaluation && f_evaluator;
+        StateID id = open_list->remove_min(need_key ? &key : nullptr);
 
         // TODO is there a way we can avoid creating the state here and then
         //      recreate it outside of this function with node.get_state()?
@@ -564,8 +752,11 @@ pair<SearchNode, bool> TopKEagerSearch::fetch_next_node() {
             continue;
         }
 
+        if (lazy_evaluation && !evaluate_fetched_node(node, key))
+            continue;
+
         node.close();
-        sort_and_remove(s);
+        finalize_incoming_heap(s);
 
         assert(!node.is_dead_end());
         update_f_value_statistics(node);
@@ -574,6 +765,67 @@ pair<SearchNode, bool> TopKEagerSearch::fetch_next_node() {
     }
 }
 
+/*
+  Queues a successor of the expanded node without evaluating it. Its key is
+  computed from the cache and the g value of the expanded node, so its f
+  value is f(parent). For a consistent heuristic, h(succ) >= h(parent) - c
+  holds for the cost c of the operator, so f(parent) is a lower bound on
+  the f value of the successor.
+*/
+void TopKEagerSearch::insert_deferred(
+    EvaluationContext &parent_eval_context, const SearchNode &parent_node,
+    bool is_preferred, StateID id) {
+    EvaluationContext deferred_eval_context(
+        parent_eval_context.get_cache(), parent_node.get_g(), is_preferred,
+        nullptr);
+    open_list->insert(deferred_eval_context, id);
+}
+
+/*
+  With lazy evaluation, a state is evaluated when it is fetched for the
+  first time. Returns whether the node should be expanded now. Without an
+  f evaluator (greedy search), every fetched node that is not a dead end
+  is expanded, as in lazy search. With an f evaluator (A*, K*), a deferred
+  node was queued with a lower bound on its f value (see insert_deferred).
+  If its real f value differs from that key, it is put back with its own
+  values. Other nodes have been queued with their own values already, so
+  an entry whose key is below the current f value is outdated. Nodes are
+  thus expanded in the order of their f values, which the path graph
+  relies on.
+*/
+bool TopKEagerSearch::evaluate_fetched_node(SearchNode &node,
+                                            const vector<int> &key) {
+    if (node.is_dead_end())
+        return false;
+    GlobalState s = node.get_state();
+    bool deferred = (*evaluation_deferred)[s];
+    EvaluationContext eval_context(s, node.get_g(), true, &statistics);
+    if (deferred) {
+        (*evaluation_deferred)[s] = false;
+        statistics.inc_evaluated_states();
+    }
+    if (open_list->is_dead_end(eval_context)) {
+        node.mark_as_dead_end();
+        statistics.inc_dead_ends();
+        return false;
+    }
+    if (deferred && search_progress.check_progress(eval_context)) {
+        print_checkpoint_line(node.get_g());
+        reward_progress();
+    }
+    if (f_evaluator) {
+        assert(!key.empty());
+        int f = eval_context.get_heuristic_value(f_evaluator);
+        if (deferred && f != key[0]) {
+            open_list->insert(eval_context, s.get_id());
+            return false;
+        } else if (f > key[0]) {
+            return false;
+        }
+    }
+    return true;
+}
+
 void TopKEagerSearch::reward_progress() {
     // Boost the "preferred operator" open lists somewhat whenever
     // one of the heuristics finds a state with a new best h value.
@@ -616,6 +868,46 @@ void add_top_k_option(OptionParser &parser) {
     parser.add_option<int>("k", "Number of plans", "-1");
     parser.add_option<double>("q", "Quality bound multiplier (of optimal solution cost)", "0.0");
     parser.add_option<bool>("skip_reorderings", "Skip plans that are reorderings of the previously dumped plans", "false");
+    parser.add_option<int>(
+        "evaluation_threads",
+        "Number of threads that evaluate the heuristics for the new successors "
+        "of an expanded state (0: one per core). The search behaves exactly "
+        "as with serial evaluation. Heuristics with path-dependent "
+        "information (landmark count) are always evaluated serially.",
+        "1",
+        Bounds("0", "infinity"));
+    parser.add_option<bool>(
+        "lazy_evaluation",
+        "Evaluate a state when it is fetched from the open list instead of "
+        "when it is generated, as lazy search does. Until then, it is queued "
+        "with the heuristic values and the g value of the expanded state. "
+        "With an f evaluator (top_k_astar, kstar), this key is a lower bound "
+        "on the f value for consistent heuristics, and fetched states whose "
+        "f value differs from their key are put back, so states are still "
+        "expanded in the order of their f values. This needs the f value to "
+        "be the first component of the open list keys.",
+        "false");
+
+    vector<string> verbosity_levels;
+    vector<string> verbosity_level_docs;
+    verbosity_levels.push_back("silent");
+    verbosity_level_docs.push_back(
+        "silent: no output during construction, only starting and final "
+        "statistics");
+    verbosity_levels.push_back("normal");
+    verbosity_level_docs.push_back(
+        "normal: basic output during construction, starting and final "
+        "statistics");
+    verbosity_levels.push_back("verbose");
+    verbosity_level_docs.push_back(
+        "verbose: full output during construction, starting and final "
+        "statistics");
+    parser.add_enum_option(
+        "verbosity",
+        verbosity_levels,
+        "Option to specify the level of verbosity.",
+        "silent",
+        verbosity_level_docs);
 }
 
 static SearchEngine *_parse(OptionParser &parser) {
@@ -5,6 +5,7 @@
 #include "../option_parser.h"
 #include "../open_lists/open_list.h"
 #include "../state_action_pair.h"
+#include "../utils/hash.h"
 #include "../utils/util.h"
 
 #include "../kstar/kstar_types.h"
@@ -14,9 +15,11 @@
 #include <vector>
 #include <queue>
 #include <iostream>
+#include <unordered_map>
 
 class GlobalOperator;
 class Heuristic;
+class ParallelHeuristicEvaluator;
 class PruningMethod;
 class ScalarEvaluator;
 namespace options {
@@ -24,25 +27,48 @@ class Options;
 }
 
 namespace top_k_eager_search {
-typedef shared_ptr<StateActionPair> Sap;
+using kstar::SapID;
 
 class TopKEagerSearch : public SearchEngine {
     const bool reopen_closed_nodes;
 protected:
-    const int number_of_plans;
-    const double quality_bound;
+    // Not constant, a resumed K* search can raise them
+    int number_of_plans;
+    double quality_bound;
+    // Whether successors were skipped because of the cost bound
+    bool pruned_by_bound;
     std::unique_ptr<StateOpenList> open_list;
     ScalarEvaluator *f_evaluator;
     std::vector<Heuristic *> heuristics;
     std::vector<Heuristic *> preferred_operator_heuristics;
     std::shared_ptr<PruningMethod> pruning_method;
+    // 1 for serial evaluation, 0 for one thread per core
+    int num_evaluation_threads;
+    std::unique_ptr<ParallelHeuristicEvaluator> parallel_evaluator;
+    // With lazy evaluation, new successors are queued with the heuristic
+    // values of the expanded state and only evaluated when fetched
+    bool lazy_evaluation;
+    // States queued with the values of their parent, not evaluated yet.
+    // Only allocated with lazy evaluation.
+    std::unique_ptr<PerStateInformation<bool>> evaluation_deferred;
     bool interrupted;
     StateID goal_state = StateID::no_state;
     bool all_nodes_expanded = false;
     int counter = 0;
     // std::vector<kstar::StateSequence> top_k_plans_states;
-    PerStateInformation<vector<Sap>> incomming_heap;
-    PerStateInformation<vector<Sap>> tree_heap;
+    kstar::SapArena saps;
+    kstar::InHeap in_heap_nodes;
+    PerStateInformation<kstar::IncomingHeapInfo> incomming_heap;
+    // Edges added to incoming heaps indexed by (from state, operator). The
+    // pair determines the target state, so it identifies the edge.
+    std::unordered_map<std::pair<int, int>, SapID> incoming_edges;
+    // Tree heaps are persistent: H_T(s) shares all but O(log n) of its
+    // nodes with H_T(parent(s)).
+    kstar::TreeHeap tree_heap_nodes;
+    PerStateInformation<kstar::TreeHeapInfo> tree_heap;
+    // Incremented whenever an incoming heap changes. Tree heaps built for
+    // an older version are checked for changes before they are reused.
+    int heap_version;
 
     // g-value of the most expensive successor of the current
     // top node of the djkstra queue
@@ -55,6 +81,10 @@ protected:
     // void update_next_node_f();
     // int get_f_value(StateID id);
     std::pair<SearchNode, bool> fetch_next_node();
+    void insert_deferred(EvaluationContext &parent_eval_context,
+                         const SearchNode &parent_node, bool is_preferred,
+                         StateID id);
+    bool evaluate_fetched_node(SearchNode &node, const std::vector<int> &key);
     void start_f_value_statistics(EvaluationContext &eval_context);
     void update_f_value_statistics(const SearchNode &node);
     void reward_progress();
@@ -67,15 +97,18 @@ protected:
                              SearchNode succ_node);
     void dump_incoming_heap(const GlobalState& s) const;
     void dump_tree_heap(const GlobalState& s) const;
+    void update_tree_heap(const GlobalState &state, int parent_root);
 
     void remove_tree_edge(GlobalState s);
-    void sort_and_remove(GlobalState  s);
-    std::string get_node_label(StateActionPair &edge);
-    std::string get_node_name(StateActionPair &edge);
+    void finalize_incoming_heap(GlobalState s);
+    void refresh_incoming_heap(SearchNode node);
+    void get_incoming_edges(const GlobalState &s, vector<SapID> &edges) const;
+    std::string get_node_label(const StateActionPair &edge);
+    std::string get_node_name(const StateActionPair &edge);
 
 public:
     explicit TopKEagerSearch(const options::Options &opts);
-    virtual ~TopKEagerSearch() = default;
+    virtual ~TopKEagerSearch() override;
     virtual void print_statistics() const override;
     void init_tree_heap(GlobalState& state);
 };
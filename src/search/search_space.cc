@@ -15,11 +15,13 @@ using namespace std;
 SearchNode::SearchNode(const StateRegistry &state_registry,
                        StateID state_id,
                        SearchNodeInfo &info,
-                       OperatorCost cost_type)
+                       OperatorCost cost_type,
+                       int &tree_version)
     : state_registry(state_registry),
       state_id(state_id),
       info(info),
-      cost_type(cost_type) {
+      cost_type(cost_type),
+      tree_version(tree_version) {
     assert(state_id != StateID::no_state);
 }
 
@@ -83,6 +85,7 @@ void SearchNode::reopen(const SearchNode &parent_node,
     info.real_g = parent_node.info.real_g + parent_op->get_cost();
     info.parent_state_id = parent_node.get_state_id();
     info.creating_operator = get_op_index_hacked(parent_op);
+    ++tree_version;
 }
 
 // like reopen, except doesn't change status
@@ -96,6 +99,7 @@ void SearchNode::update_parent(const SearchNode &parent_node,
     info.real_g = parent_node.info.real_g + parent_op->get_cost();
     info.parent_state_id = parent_node.get_state_id();
     info.creating_operator = get_op_index_hacked(parent_op);
+    ++tree_version;
 }
 
 void SearchNode::close() {
@@ -127,12 +131,14 @@ void SearchNode::dump() const {
 SearchSpace::SearchSpace(StateRegistry &state_registry, OperatorCost cost_type)
     : state_registry(state_registry),
       cost_type(cost_type),
-	  plan_simulation_index(1) {
+	  plan_simulation_index(1),
+      tree_version(0) {
 }
 
 SearchNode SearchSpace::get_node(const GlobalState &state) {
     return SearchNode(
-        state_registry, state.get_id(), search_node_infos[state], cost_type);
+        state_registry, state.get_id(), search_node_infos[state], cost_type,
+        tree_version);
 }
 
 void SearchSpace::trace_path(const GlobalState &goal_state,
@@ -153,50 +159,6 @@ void SearchSpace::trace_path(const GlobalState &goal_state,
     reverse(path.begin(), path.end());
 }
 
-void SearchSpace::dump_state(std::ostream& os, const GlobalState& state) const {
-    int num_vars = state_registry.get_num_variables();
-    vector<string> names;
-    for (int var=0; var < num_vars; ++var) {
-        string fact_name = state_registry.get_task().get_fact_name(FactPair(var, state[var]));        
-        if (fact_name == "__special_value_false__" || fact_name == "__special_value_true__")
-            continue;
-        if (fact_name == "<none of those>")
-            continue;
-        if (fact_name.compare(0, 11, "NegatedAtom") == 0)
-            continue;
-
-        names.push_back(fact_name);
-    }
-
-    os << "[" << endl;
-    size_t i = 0;
-    for (; i < names.size() - 1; ++i) {
-        os << "\"" << names[i] << "\"," << endl;
-    }
-    os << "\"" << names[i] << "\"" << endl;
-    os << "]" << endl;
-}
-
-void SearchSpace::trace_from_plan(const std::vector<const GlobalOperator *> &plan, std::vector<StateID> &plan_trace) const {
-    assert(plan_trace.size() == 0);
-    GlobalState current_state = state_registry.get_initial_state();
-    for (size_t i=0; i < plan.size(); ++i) {
-        const GlobalOperator *op = plan[i];
-        current_state = state_registry.get_successor_state(current_state, *op);
-        plan_trace.push_back(current_state.get_id());
-    }
-}
-
-void SearchSpace::dump_trace(const std::vector<StateID> &plan_trace, std::ostream& os) const {
-
-    GlobalState current_state = state_registry.get_initial_state();
-    dump_state(os, current_state);
-    for (size_t i=0; i < plan_trace.size(); ++i) {
-        os << "," << endl;
-        dump_state(os, state_registry.lookup_state(plan_trace[i]));
-    }
-}
-
 void SearchSpace::dump() const {
     for (PerStateInformation<SearchNodeInfo>::const_iterator it =
              search_node_infos.begin(&state_registry);
@@ -17,11 +17,13 @@ class SearchNode {
     StateID state_id;
     SearchNodeInfo &info;
     OperatorCost cost_type;
+    int &tree_version;
 public:
     SearchNode(const StateRegistry &state_registry,
                StateID state_id,
                SearchNodeInfo &info,
-               OperatorCost cost_type);
+               OperatorCost cost_type,
+               int &tree_version);
 
     StateID get_state_id() const {
         return state_id;
@@ -58,6 +60,8 @@ public:
     StateRegistry &state_registry;
     OperatorCost cost_type;
     int plan_simulation_index;
+    // Incremented whenever a node that has a parent gets a new one
+    int tree_version;
 
     SearchSpace(StateRegistry &state_registry, OperatorCost cost_type);
 
@@ -65,10 +69,6 @@ public:
     void trace_path(const GlobalState &goal_state,
                     std::vector<const GlobalOperator *> &path) const;
 
-    void dump_state(std::ostream& os, const GlobalState& state) const;
-    void dump_trace(const std::vector<StateID> &plan_trace, std::ostream& os) const;
-    void trace_from_plan(const std::vector<const GlobalOperator *> &plan, std::vector<StateID> &plan_trace) const;
-
     void dump() const;
     void print_statistics() const;
     void dump_dot() const;
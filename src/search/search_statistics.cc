@@ -5,12 +5,21 @@
 #include "utils/timer.h"
 #include "utils/system.h"
 
+#include <cassert>
+#include <iomanip>
 #include <iostream>
 
 using namespace std;
 
 
-SearchStatistics::SearchStatistics() {
+static const char *PHASE_NAMES[] = {
+	"astar", "djkstra", "plan_extraction", "deduplication", "plan_output"
+};
+
+SearchStatistics::SearchStatistics()
+	: start_time(Clock::now()),
+	  phase_start_time(start_time),
+	  phase_seconds(static_cast<int>(SearchPhase::NUM_PHASES), 0.0) {
     expanded_states = 0;
     reopened_states = 0;
     evaluated_states = 0;
@@ -23,6 +32,11 @@ SearchStatistics::SearchStatistics() {
 	num_opt_plans = 0;
 	num_djkstra_runs = 0;	
 	total_djkstra_node_generations = 0;
+	num_avoided_reextractions = 0;
+	num_rejected_before_extraction = 0;
+	num_rejected_non_simple = 0;
+	num_termination_checks = 0;
+	reordering_check_memory = 0;
 
     lastjump_expanded_states = 0;
     lastjump_reopened_states = 0;
@@ -32,6 +46,47 @@ SearchStatistics::SearchStatistics() {
     lastjump_f_value = -1;
 }
 
+void SearchStatistics::inc_djkstra_runs(int f_layer) {
+	++num_djkstra_runs;
+	if (djkstra_runs_per_f_layer.empty() ||
+		djkstra_runs_per_f_layer.back().first != f_layer) {
+		djkstra_runs_per_f_layer.emplace_back(f_layer, 0);
+	}
+	++djkstra_runs_per_f_layer.back().second;
+}
+
+void SearchStatistics::add_elapsed_phase_time(Clock::time_point now) {
+	if (!active_phases.empty()) {
+		phase_seconds[static_cast<int>(active_phases.back())] +=
+			chrono::duration<double>(now - phase_start_time).count();
+	}
+	phase_start_time = now;
+}
+
+void SearchStatistics::start_phase(SearchPhase phase) {
+	add_elapsed_phase_time(Clock::now());
+	active_phases.push_back(phase);
+}
+
+void SearchStatistics::end_phase() {
+	assert(!active_phases.empty());
+	add_elapsed_phase_time(Clock::now());
+	active_phases.pop_back();
+}
+
+double SearchStatistics::get_phase_time(SearchPhase phase) const {
+	return phase_seconds[static_cast<int>(phase)];
+}
+
+double SearchStatistics::get_elapsed_time() const {
+	return chrono::duration<double>(Clock::now() - start_time).count();
+}
+
+void SearchStatistics::take_memory_snapshot(const string &event) {
+	memory_snapshots.push_back(
+		{get_elapsed_time(), event, utils::get_peak_memory_in_kb()});
+}
+
 void SearchStatistics::report_f_value_progress(int f) {
     if (f > lastjump_f_value) {
         lastjump_f_value = f;
@@ -84,4 +139,76 @@ void SearchStatistics::print_detailed_statistics() const {
 	cout << "Number of djkstra runs: "<< num_djkstra_runs << std::endl;
 	cout << "Total number of djkstra node generations: " 
 			  << total_djkstra_node_generations << std::endl;
+	cout << "Number of termination checks: "
+			  << num_termination_checks << std::endl;
+	cout << "Number of avoided plan re-extractions: "
+			  << num_avoided_reextractions << std::endl;
+	cout << "Number of plans rejected before extraction: "
+			  << num_rejected_before_extraction << std::endl;
+	cout << "Number of rejected non-simple plans: "
+			  << num_rejected_non_simple << std::endl;
+	cout << "Memory for reordering checks: "
+			  << reordering_check_memory / 1024 << " KB" << std::endl;
+	for (int i = 0; i < static_cast<int>(SearchPhase::NUM_PHASES); ++i) {
+		cout << "Time in phase " << PHASE_NAMES[i] << ": "
+			 << phase_seconds[i] << "s" << endl;
+	}
+}
+
+void SearchStatistics::print_progress_line() const {
+	cout << "[progress] {\"time\": " << get_elapsed_time()
+		 << ", \"expanded\": " << expanded_states
+		 << ", \"generated\": " << generated_states
+		 << ", \"plans\": " << num_plans_found
+		 << ", \"djkstra_runs\": " << num_djkstra_runs
+		 << ", \"djkstra_node_generations\": "
+		 << total_djkstra_node_generations
+		 << ", \"peak_memory_kb\": " << utils::get_peak_memory_in_kb()
+		 << "}" << endl;
+}
+
+void SearchStatistics::dump_json(ostream &os) const {
+	os << setprecision(6) << fixed;
+	os << "{\n  \"time\": " << get_elapsed_time() << ",\n";
+	os << "  \"phase_times\": {";
+	for (int i = 0; i < static_cast<int>(SearchPhase::NUM_PHASES); ++i) {
+		os << (i ? ", " : "") << "\"" << PHASE_NAMES[i] << "\": "
+		   << phase_seconds[i];
+	}
+	os << "},\n";
+	os << "  \"counters\": {"
+	   << "\"expanded\": " << expanded_states
+	   << ", \"reopened\": " << reopened_states
+	   << ", \"evaluated\": " << evaluated_states
+	   << ", \"evaluations\": " << evaluations
+	   << ", \"generated\": " << generated_states
+	   << ", \"dead_ends\": " << dead_end_states
+	   << ", \"generated_ops\": " << generated_ops
+	   << ", \"plans\": " << num_plans_found
+	   << ", \"optimal_plans\": " << num_opt_plans
+	   << ", \"djkstra_runs\": " << num_djkstra_runs
+	   << ", \"djkstra_node_generations\": "
+	   << total_djkstra_node_generations
+	   << ", \"termination_checks\": " << num_termination_checks
+	   << ", \"avoided_reextractions\": " << num_avoided_reextractions
+	   << ", \"rejected_before_extraction\": "
+	   << num_rejected_before_extraction
+	   << ", \"rejected_non_simple\": " << num_rejected_non_simple
+	   << ", \"reordering_check_memory_bytes\": " << reordering_check_memory
+	   << "},\n";
+	os << "  \"djkstra_runs_per_f_layer\": [";
+	for (size_t i = 0; i < djkstra_runs_per_f_layer.size(); ++i) {
+		os << (i ? ", " : "") << "{\"f\": " << djkstra_runs_per_f_layer[i].first
+		   << ", \"runs\": " << djkstra_runs_per_f_layer[i].second << "}";
+	}
+	os << "],\n";
+	os << "  \"memory_snapshots\": [";
+	for (size_t i = 0; i < memory_snapshots.size(); ++i) {
+		const MemorySnapshot &snapshot = memory_snapshots[i];
+		os << (i ? ",\n    " : "\n    ") << "{\"time\": " << snapshot.time
+		   << ", \"event\": \"" << snapshot.event
+		   << "\", \"peak_memory_kb\": " << snapshot.peak_memory_kb << "}";
+	}
+	os << "],\n";
+	os << "  \"peak_memory_kb\": " << utils::get_peak_memory_in_kb() << "\n}\n";
 }
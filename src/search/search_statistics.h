@@ -9,28 +9,72 @@
   methods.
 */
 
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+#include <string>
+#include <utility>
+#include <vector>
+
+/*
+  Phases of the top-k search whose wall-clock time is measured. Phases
+  can be nested (e.g., plan extraction happens during the path graph
+  search); the time of a phase excludes the phases nested in it.
+*/
+enum class SearchPhase {
+	ASTAR,
+	DJKSTRA,
+	PLAN_EXTRACTION,
+	DEDUPLICATION,
+	PLAN_OUTPUT,
+	NUM_PHASES
+};
+
 class SearchStatistics {
     // General statistics
-    int expanded_states;  // no states for which successors were generated
-    int evaluated_states; // no states for which h fn was computed
-    int evaluations;      // no of heuristic evaluations performed
-    int generated_states; // no states created in total (plus those removed since already in close list)
-    int reopened_states;  // no of *closed* states which we reopened
-    int dead_end_states;
+    int64_t expanded_states;  // no states for which successors were generated
+    int64_t evaluated_states; // no states for which h fn was computed
+    int64_t evaluations;      // no of heuristic evaluations performed
+    int64_t generated_states; // no states created in total (plus those removed since already in close list)
+    int64_t reopened_states;  // no of *closed* states which we reopened
+    int64_t dead_end_states;
 
-    int generated_ops;    // no of operators that were returned as applicable
+    int64_t generated_ops;    // no of operators that were returned as applicable
 
     // Statistics related to f values
     int lastjump_f_value; //f value obtained in the last jump
-    int lastjump_expanded_states; // same guy but at point where the last jump in the open list
-    int lastjump_reopened_states; // occurred (jump == f-value of the first node in the queue increases)
-    int lastjump_evaluated_states;
-    int lastjump_generated_states;
+    int64_t lastjump_expanded_states; // same guy but at point where the last jump in the open list
+    int64_t lastjump_reopened_states; // occurred (jump == f-value of the first node in the queue increases)
+    int64_t lastjump_evaluated_states;
+    int64_t lastjump_generated_states;
+
+	int64_t num_plans_found;
+	int64_t num_opt_plans;
+	int64_t num_djkstra_runs;
+	int64_t total_djkstra_node_generations;
+	int64_t num_avoided_reextractions;
+	int64_t num_rejected_before_extraction;
+	int64_t num_rejected_non_simple;
+	int64_t num_termination_checks;
+	size_t reordering_check_memory; // bytes used to detect reorderings of plans
 
-	int num_plans_found;	
-	int num_opt_plans;
-	int num_djkstra_runs;	
-	int total_djkstra_node_generations;
+	// Phase timing uses a monotonic clock, independent of utils::g_timer
+	typedef std::chrono::steady_clock Clock;
+	Clock::time_point start_time;
+	Clock::time_point phase_start_time; // last change of the current phase
+	std::vector<SearchPhase> active_phases;
+	std::vector<double> phase_seconds;
+	// (f layer, number of runs) in the order the f layers were reached
+	std::vector<std::pair<int, int64_t>> djkstra_runs_per_f_layer;
+	struct MemorySnapshot {
+		double time;
+		std::string event;
+		int peak_memory_kb;
+	};
+	std::vector<MemorySnapshot> memory_snapshots;
+
+	void add_elapsed_phase_time(Clock::time_point now);
 
     void print_f_line() const;
 public:
@@ -38,31 +82,46 @@ public:
     ~SearchStatistics() = default;
 
     // Methods that update statistics.
-    void inc_expanded(int inc = 1) {expanded_states += inc; }
-    void inc_evaluated_states(int inc = 1) {evaluated_states += inc; }
-    void inc_generated(int inc = 1) {generated_states += inc; }
-    void inc_reopened(int inc = 1) {reopened_states += inc; }
-    void inc_generated_ops(int inc = 1) {generated_ops += inc; }
-    void inc_evaluations(int inc = 1) {evaluations += inc; }
-    void inc_dead_ends(int inc = 1) {dead_end_states += inc; }
+    void inc_expanded(int64_t inc = 1) {expanded_states += inc; }
+    void inc_evaluated_states(int64_t inc = 1) {evaluated_states += inc; }
+    void inc_generated(int64_t inc = 1) {generated_states += inc; }
+    void inc_reopened(int64_t inc = 1) {reopened_states += inc; }
+    void inc_generated_ops(int64_t inc = 1) {generated_ops += inc; }
+    void inc_evaluations(int64_t inc = 1) {evaluations += inc; }
+    void inc_dead_ends(int64_t inc = 1) {dead_end_states += inc; }
     void inc_plans_found(int inc = 1){num_plans_found += inc;};
     void inc_opt_plans(int inc = 1){num_opt_plans += inc;};
 	
     void reset_plans_found(){num_plans_found = 0;};
     void reset_opt_found(){num_opt_plans = 0;};
 
-    void inc_djkstra_runs(int inc = 1){num_djkstra_runs += inc;};
+    // Counts a run of the path graph search that starts in the given f layer
+    void inc_djkstra_runs(int f_layer);
     void inc_total_djkstra_generations(int inc = 1){total_djkstra_node_generations += inc;};
+    void inc_avoided_reextractions(int inc = 1){num_avoided_reextractions += inc;};
+    void inc_rejected_before_extraction(int inc = 1){num_rejected_before_extraction += inc;};
+    void inc_rejected_non_simple(int inc = 1){num_rejected_non_simple += inc;};
+    void inc_termination_checks(int inc = 1){num_termination_checks += inc;};
+    void set_reordering_check_memory(size_t bytes){reordering_check_memory = bytes;};
 
     // Methods that access statistics.
-    int get_expanded() const {return expanded_states; }
-    int get_evaluated_states() const {return evaluated_states; }
-    int get_evaluations() const {return evaluations; }
-    int get_generated() const {return generated_states; }
-    int get_reopened() const {return reopened_states; }
-    int get_generated_ops() const {return generated_ops; }
+    int64_t get_expanded() const {return expanded_states; }
+    int64_t get_evaluated_states() const {return evaluated_states; }
+    int64_t get_evaluations() const {return evaluations; }
+    int64_t get_generated() const {return generated_states; }
+    int64_t get_reopened() const {return reopened_states; }
+    int64_t get_generated_ops() const {return generated_ops; }
     
-    int get_num_djkstra_runs() const {return num_djkstra_runs; }
+    int64_t get_num_djkstra_runs() const {return num_djkstra_runs; }
+
+	void start_phase(SearchPhase phase);
+	void end_phase();
+	double get_phase_time(SearchPhase phase) const;
+	// Seconds since the statistics were created
+	double get_elapsed_time() const;
+	// Records the peak memory. All snapshots are kept, so take them only at
+	// phase boundaries, not in loops.
+	void take_memory_snapshot(const std::string &event);
     /*
       Call the following method with the f value of every expanded
       state. It will notice "jumps" (i.e., when the expanded f value
@@ -84,6 +143,24 @@ public:
     // output
     void print_basic_statistics() const;
     void print_detailed_statistics() const;
+    // One line with the current counters, for monitoring long searches
+    void print_progress_line() const;
+    void dump_json(std::ostream &os) const;
+};
+
+// Measures the time of a phase for the lifetime of the object
+class SearchPhaseTimer {
+	SearchStatistics &statistics;
+public:
+	SearchPhaseTimer(SearchStatistics &statistics, SearchPhase phase)
+		: statistics(statistics) {
+		statistics.start_phase(phase);
+	}
+	~SearchPhaseTimer() {
+		statistics.end_phase();
+	}
+	SearchPhaseTimer(const SearchPhaseTimer &) = delete;
+	SearchPhaseTimer &operator=(const SearchPhaseTimer &) = delete;
 };
 
 #endif
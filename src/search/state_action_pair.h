@@ -4,69 +4,49 @@
 //#include <boost/functional/hash.hpp>
 
 #include "state_id.h"
-#include "state_registry.h"
-#include "search_space.h"
 #include "global_operator.h"
-#include "utils/util.h"
+#include "globals.h"
 #include "utils/hash.h"
 
+/*
+  An edge (from, to) of the explored state space. The g values of both end
+  points and the resulting sidetrack cost delta are cached in the edge, so
+  that ordering edges does not need any state lookups. Whoever changes the
+  g value of an end point has to call refresh().
+
+  K* stores edges and path graph nodes in arenas (see kstar/arena.h) and
+  refers to them by index.
+*/
 class StateActionPair {
 public:
 	StateID from;
 	StateID to;
-	const  GlobalOperator* op;
-	const StateRegistry* reg;
-
-	SearchSpace* ssp;
-	static const StateActionPair no_sap; 
-
-	StateActionPair(const StateActionPair& other)
-			: from(other.from), to(other.to), op(other.op), reg(other.reg), ssp(other.ssp) {
-
-	};
-
-	StateActionPair(StateID from, StateID to, const GlobalOperator* op,
-					const StateRegistry* reg, SearchSpace* ssp)
-		: from(from), to(to), op(op), reg(reg), ssp(ssp) {
-
-	};
-
-	~StateActionPair() {
-	}
-
-	GlobalState get_from_state() {
-		return reg->lookup_state(from);			
-	};
-
-	GlobalState get_to_state() {
-		return reg->lookup_state(to);			
+	int op_index;
+	int from_g;
+	int to_g;
+	int delta;
+
+	StateActionPair(StateID from, StateID to, int op_index,
+					int from_g = 0, int to_g = 0)
+		: from(from), to(to), op_index(op_index), from_g(0), to_g(0), delta(-1) {
+		refresh(from_g, to_g);
 	};
 
-	int from_g() const {
-		const GlobalState from_state = reg->lookup_state(from);
-		SearchNode from_node = ssp->get_node(from_state);
-		return from_node.get_g();
+	const GlobalOperator *get_op() const {
+		return &g_operators[op_index];
 	};
 
-	int edge_cost() const {
-		return op->get_cost();
-	};	
-	
-	int to_g() const {
-		const GlobalState to_state = reg->lookup_state(to);
-		SearchNode to_node = ssp->get_node(to_state);
-		return to_node.get_g();
+	void refresh(int new_from_g, int new_to_g) {
+		from_g = new_from_g;
+		to_g = new_to_g;
+		if (from == StateID::no_state)
+			delta = -1;
+		else
+			delta = from_g + get_op()->get_cost() - to_g;
 	};
 
 	int get_delta() const {
-		if (from == StateID::no_state)
-			return -1;
-		const GlobalState to_state = reg->lookup_state(to);
-		const GlobalState from_state = reg->lookup_state(from);
-		SearchNode from_node = ssp->get_node(from_state);
-		SearchNode to_node = ssp->get_node(to_state);
-
-		return from_node.get_g() + op->get_cost() - to_node.get_g();
+		return delta;
 	};
 
 	size_t hash() const {
@@ -79,9 +59,9 @@ public:
 	}
 
 	bool operator<(const StateActionPair &other) const {
-		if (this->get_delta() < other.get_delta())
+		if (delta < other.delta)
 			return true;
-		if (this->get_delta() > other.get_delta())
+		if (delta > other.delta)
             return false;
 		if (this->hash() < other.hash())
 			return true;
@@ -89,107 +69,51 @@ public:
 	};
 
 	bool operator==(const StateActionPair& other) const {
-		if (from != other.from)
-			return false;
-		if (to != other.to)
-			return false;
-		if (op->get_index() != other.op->get_index())
-			return false;
-		return true;
+		return from == other.from && to == other.to && op_index == other.op_index;
 	};
 
 	bool operator!=(const StateActionPair &other) const {
-		if (*this == other)
-			return false;
-		return true;
+		return !(*this == other);
 	}
 };
-struct Node;
 
+/*
+  A node of the path graph. It refers to its edge and to the node it was
+  generated from (its parent) by their arena indices.
+*/
 struct Node {
-	int id = -1;
 	int g = -1;
-	shared_ptr<StateActionPair> sap = nullptr;
+	// Index of the edge of the node (-1 for the root of the path graph)
+	int sap = -1;
 	StateID heap_state = StateID::no_state;
-	bool is_inheap_node = false;
-
-	Node() {
-		id = -1;
-		g = -1;
-		sap = nullptr;
-		heap_state = StateID::no_state;
-	}
-
-	Node (const Node &n) {
-		id = n.id;
-		g = n.g;
-		sap = n.sap;
-		heap_state = n.heap_state;
-		is_inheap_node = n.is_inheap_node;
-	}
-
-	Node(int g, shared_ptr<StateActionPair> sap, StateID heap_state)
-	:id(-1), g(g), sap(sap), heap_state(heap_state){
-	};
-
-	size_t hash() const{
-		size_t value_sap = sap->hash();
-		size_t value_heap =  this->heap_state.hash();
-		size_t seed = 0;
-		utils::hash_combine(seed, value_sap);
-		utils::hash_combine(seed, value_heap);
-		utils::hash_combine(seed, id);
-		return seed;
-	}
-
-    bool operator==(const Node& other) const {
-		if (id != other.id)
-			return false;
-		if (g != other.g)
-			return false;
-		if ((!sap && other.sap) || (sap && !other.sap))
-            return false;
-
-        if (*sap != *other.sap)
-			return false;
-
-		if (heap_state != other.heap_state)
-			return false;
-		return true;
-	};
-
-    bool operator<(const Node &other) const {
-		if (other.g < g)
-            return true;
-        if (other.g > g)
-			return false;
-		// Tie Breaking if they have equal g_values
-		size_t hash = this->hash();
-		size_t other_hash = other.hash();
-		if (other_hash  < hash)
-			return true;
-		return false;
-	};
-};
-
-namespace std {
-	template<>
-	struct hash<StateActionPair> {
-		std::size_t operator()(const StateActionPair &sap) const {
-			return sap.hash();
-		}
-	};
-    template<>
-	struct hash<Node> {
-		std::size_t operator()(const Node &node) const {
-			return node.hash();
-		}
-	};
-}
-
-template <typename T> struct Cmp {
-    bool operator() (const T &lhs, const T &rhs) {
-		return *lhs < *rhs;
+	// Position of the node in the persistent tree heap of heap_state
+	// (-1 for nodes of incoming heaps and the root of the path graph)
+	int tree_heap_node = -1;
+	// Position of the node in the incoming heap of the target of its edge
+	// (-1 for the root of the path graph)
+	int in_heap_node = -1;
+	// Index of the parent node (-1 for the root of the path graph)
+	int parent = -1;
+	// Index of the child reached via the cross edge of the node
+	int cross_child = -1;
+	// Sidetrack list (see kstar::SidetrackArena) of the edges followed by
+	// cross edges on the way from the root, the most recent first
+	int sidetracks = -1;
+	// Whether the node was reached from its parent via a cross edge
+	bool is_cross_edge = false;
+	// A node is stale if the heap its cross edge pointed to has been
+	// replaced since. Stale nodes and their descendants are dropped.
+	bool stale = false;
+	// Whether the node descends from a cross child generated again after
+	// A* changed the heaps (so it may represent an already seen plan)
+	bool regenerated = false;
+	// Epoch of the path graph in which the node was last found not stale
+	int valid_epoch = -1;
+
+	Node() = default;
+
+	Node(int g, int sap, StateID heap_state)
+		: g(g), sap(sap), heap_state(heap_state) {
 	};
 };
 #endif
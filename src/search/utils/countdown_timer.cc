@@ -5,8 +5,8 @@
 using namespace std;
 
 namespace utils {
-CountdownTimer::CountdownTimer(double max_time)
-    : max_time(max_time) {
+CountdownTimer::CountdownTimer(double max_time, bool wall_clock)
+    : timer(wall_clock), max_time(max_time) {
 }
 
 CountdownTimer::~CountdownTimer() {
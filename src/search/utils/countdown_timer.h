@@ -10,7 +10,7 @@ class CountdownTimer {
     Timer timer;
     double max_time;
 public:
-    explicit CountdownTimer(double max_time);
+    explicit CountdownTimer(double max_time, bool wall_clock = false);
     ~CountdownTimer();
     bool is_expired() const;
     double get_elapsed_time() const;
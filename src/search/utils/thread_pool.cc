@@ -0,0 +1,93 @@
+#include "thread_pool.h"
+
+#include <algorithm>
+#include <cassert>
+
+using namespace std;
+
+namespace utils {
+ThreadPool::ThreadPool(int num_threads)
+    : generation(0),
+      num_busy_workers(0),
+      shutting_down(false),
+      task_function(nullptr),
+      num_tasks(0),
+      next_task(0) {
+    assert(num_threads >= 1);
+    for (int thread = 1; thread < num_threads; ++thread) {
+        workers.emplace_back(&ThreadPool::work, this, thread);
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        shutting_down = true;
+    }
+    work_available.notify_all();
+    for (thread &worker : workers) {
+        worker.join();
+    }
+}
+
+int ThreadPool::get_num_threads() const {
+    return workers.size() + 1;
+}
+
+void ThreadPool::run_tasks(int thread) {
+    while (true) {
+        int task = next_task.fetch_add(1, memory_order_relaxed);
+        if (task >= num_tasks)
+            break;
+        (*task_function)(task, thread);
+    }
+}
+
+void ThreadPool::work(int thread) {
+    int last_generation = 0;
+    while (true) {
+        {
+            unique_lock<mutex> lock(pool_mutex);
+            work_available.wait(lock, [&]() {
+                                    return shutting_down ||
+                                    generation != last_generation;
+                                });
+            if (shutting_down)
+                return;
+            last_generation = generation;
+        }
+        run_tasks(thread);
+        {
+            lock_guard<mutex> lock(pool_mutex);
+            --num_busy_workers;
+        }
+        work_finished.notify_one();
+    }
+}
+
+void ThreadPool::run(int num_tasks, const TaskFunction &function) {
+    if (workers.empty() || num_tasks <= 1) {
+        for (int task = 0; task < num_tasks; ++task) {
+            function(task, 0);
+        }
+        return;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        task_function = &function;
+        this->num_tasks = num_tasks;
+        next_task = 0;
+        num_busy_workers = workers.size();
+        ++generation;
+    }
+    work_available.notify_all();
+    run_tasks(0);
+    unique_lock<mutex> lock(pool_mutex);
+    work_finished.wait(lock, [this]() {return num_busy_workers == 0; });
+    task_function = nullptr;
+}
+
+int get_hardware_concurrency() {
+    return max(1u, thread::hardware_concurrency());
+}
+}
@@ -0,0 +1,55 @@
+#ifndef UTILS_THREAD_POOL_H
+#define UTILS_THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace utils {
+/*
+  A fixed set of threads for running parallel loops.
+
+  run(num_tasks, function) calls function(task, thread) for every task in
+  [0, num_tasks) and returns when all calls have finished. The calling
+  thread takes part as thread 0, so a pool with one thread does not start
+  any threads. Tasks are handed out in increasing order, but which thread
+  runs a task is not deterministic. The thread index lets callers keep
+  per-thread data without locking.
+
+  The function must not throw exceptions or call run() of the same pool.
+*/
+class ThreadPool {
+    using TaskFunction = std::function<void(int task, int thread)>;
+
+    std::vector<std::thread> workers;
+    std::mutex pool_mutex;
+    std::condition_variable work_available;
+    std::condition_variable work_finished;
+    // Incremented for every call of run(), guarded by pool_mutex
+    int generation;
+    int num_busy_workers;
+    bool shutting_down;
+    const TaskFunction *task_function;
+    int num_tasks;
+    std::atomic<int> next_task;
+
+    void run_tasks(int thread);
+    void work(int thread);
+public:
+    explicit ThreadPool(int num_threads);
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    int get_num_threads() const;
+    void run(int num_tasks, const TaskFunction &function);
+};
+
+// Number of threads the hardware supports (at least 1)
+int get_hardware_concurrency();
+}
+
+#endif
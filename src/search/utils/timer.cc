@@ -1,5 +1,7 @@
 #include "timer.h"
 
+#include "language.h"
+
 #include <ctime>
 #include <ostream>
 
@@ -32,7 +34,8 @@ void mach_absolute_difference(uint64_t end, uint64_t start, struct timespec *tp)
 #endif
 
 
-Timer::Timer() {
+Timer::Timer(bool wall_clock)
+    : wall_clock(wall_clock) {
 #if OPERATING_SYSTEM == WINDOWS
     QueryPerformanceFrequency(&frequency);
     QueryPerformanceCounter(&start_ticks);
@@ -44,6 +47,7 @@ Timer::Timer() {
 
 double Timer::current_clock() const {
 #if OPERATING_SYSTEM == WINDOWS
+    unused_variable(wall_clock);
     LARGE_INTEGER now_ticks;
     QueryPerformanceCounter(&now_ticks);
     double ticks = static_cast<double>(now_ticks.QuadPart - start_ticks.QuadPart);
@@ -51,11 +55,13 @@ double Timer::current_clock() const {
 #else
     timespec tp;
 #if OPERATING_SYSTEM == OSX
+    unused_variable(wall_clock);
     static uint64_t start = mach_absolute_time();
     uint64_t end = mach_absolute_time();
     mach_absolute_difference(end, start, &tp);
 #else
-    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &tp);
+    clock_gettime(
+        wall_clock ? CLOCK_MONOTONIC : CLOCK_PROCESS_CPUTIME_ID, &tp);
 #endif
     return tp.tv_sec + tp.tv_nsec / 1e9;
 #endif
@@ -6,10 +6,15 @@
 #include <ostream>
 
 namespace utils {
+/*
+  Measures the CPU time of the process, summed over all threads, or the
+  elapsed wall-clock time. On Windows and OSX, both are wall-clock time.
+*/
 class Timer {
     double last_start_clock;
     double collected_time;
     bool stopped;
+    bool wall_clock;
 #if OPERATING_SYSTEM == WINDOWS
     LARGE_INTEGER frequency;
     LARGE_INTEGER start_ticks;
@@ -18,7 +23,7 @@ class Timer {
     double current_clock() const;
 
 public:
-    Timer();
+    explicit Timer(bool wall_clock = false);
     ~Timer() = default;
     double operator()() const;
     double stop();